@@ -44,6 +44,8 @@ class ExpansionClientSettings
 	bool Show3DPlayerMarkers;
 	bool Show3DPartyMarkers;
 	bool Show3DGlobalMarkers;
+	//! Maximum amount of 3D markers repositioned per frame, 0 means no limit
+	int Max3DMarkersPerFrame;
 
 	bool Show2DMarkers;
 	bool Show2DClientMarkers;
@@ -134,6 +136,7 @@ class ExpansionClientSettings
 		Show3DPlayerMarkers = true;
 		Show3DPartyMarkers = true;
 		Show3DGlobalMarkers = true;
+		Max3DMarkersPerFrame = 24;
 
 		Show2DMarkers = true;
 		Show2DClientMarkers = true;
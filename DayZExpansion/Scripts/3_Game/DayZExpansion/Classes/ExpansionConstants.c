@@ -148,9 +148,13 @@ static const string EXPANSION_TRADER_ZONES_FOLDER = EXPANSION_FOLDER + "TraderZo
 static const string EXPANSION_TRADER_FOLDER = EXPANSION_FOLDER + "Traders\\";
 static const string EXPANSION_MISSIONS_FOLDER = EXPANSION_FOLDER + "Missions\\";
 static const string EXPANSION_GROUPS_FOLDER = EXPANSION_FOLDER + "Groups\\";
+static const string EXPANSION_GROUPS_MARKERS_FOLDER = EXPANSION_FOLDER + "GroupMarkers\\";
+static const string EXPANSION_GROUPS_DATABASE = EXPANSION_FOLDER + "Groups.bin";
 
 static const string EXPANSION_MAPPING_FOLDER = "DayZExpansion/Scripts/Data/Mapping/";
 static const string EXPANSION_MAPPING_EXT = ".map";
+static const string EXPANSION_MAPPING_COMPILED_EXT = ".mapb";
+static const string EXPANSION_MAPPING_COMPILED_FOLDER = EXPANSION_FOLDER + "Mapping\\";
 
 static const string EXPANSION_GENERAL_SETTINGS = EXPANSION_SETTINGS_FOLDER + "GeneralSettings.json";
 static const string EXPANSION_BOOK_SETTINGS = EXPANSION_SETTINGS_FOLDER + "BookSettings.json";
@@ -170,6 +174,8 @@ static const string EXPANSION_LOG_FOLDER = EXPANSION_FOLDER + "Logs\\";
 static const string EXPANSION_CHAT_LOG_FOLDER = EXPANSION_LOG_FOLDER + "Chat\\";
 static const string EXPANSION_MARKET_LOG_FOLDER = EXPANSION_LOG_FOLDER + "Market\\";
 static const string EXPANSION_KILLFEED_LOG_FOLDER = EXPANSION_LOG_FOLDER + "KillFeed\\";
+static const string EXPANSION_EVENTS_LOG_FOLDER = EXPANSION_LOG_FOLDER + "Events\\";
+static const string EXPANSION_EVENTS_LOG_EXT = ".ndjson";
 static const string EXPANSION_PARTY_LOG_FOLDER = EXPANSION_LOG_FOLDER + "Parties\\";
 static const string EXPANSION_MISSIONS_LOG_FOLDER = EXPANSION_LOG_FOLDER + "Missions\\";
 
@@ -181,10 +187,13 @@ static const string EXPANSION_QUEST_NPCS = EXPANSION_QUESTS_FOLDER + "QuestNPCs\
 static const string EXPANSION_QUEST_REWARDS = EXPANSION_QUESTS_FOLDER + "QuestRewards.json";
 
 static const string EXPANSION_TEMP_INTERIORS = EXPANSION_FOLDER + "TempInteriors.bin";
+static const string EXPANSION_COLLISION_CACHE = EXPANSION_FOLDER + "CollisionCache.bin";
+static const string EXPANSION_COLLISION_CACHE_PREBUILT = "DayZExpansion/Scripts/Data/CollisionCache.bin";
 
 //! On Client Only
 static const string EXPANSION_CLIENT_SETTINGS = EXPANSION_FOLDER + "settings.json";
 static const string EXPANSION_CLIENT_MARKERS = EXPANSION_FOLDER + "markers.json";
+static const string EXPANSION_CLIENT_SETTINGS_CACHE_FOLDER = EXPANSION_FOLDER + "SettingsCache\\";
 
 /**
  * InGame Menu
@@ -21,12 +21,7 @@ modded class NotificationSystem
 
 		if ( IsMissionHost() )
 		{
-			ScriptRPC rpc = new ScriptRPC();
-			rpc.Write( title );
-			rpc.Write( text );
-			rpc.Write( icon );
-			rpc.Write( color );
-			rpc.Write( time );
+			ScriptRPC rpc = Expansion_CreateRPC( title, text, icon, color, time );
 			rpc.Send( NULL, NotificationSystemRPC.Create, true, NULL );
 		}
 		else
@@ -50,12 +45,7 @@ modded class NotificationSystem
 
 		if ( IsMissionHost() )
 		{
-			ScriptRPC rpc = new ScriptRPC();
-			rpc.Write( title );
-			rpc.Write( text );
-			rpc.Write( icon );
-			rpc.Write( color );
-			rpc.Write( time );
+			ScriptRPC rpc = Expansion_CreateRPC( title, text, icon, color, time );
 			rpc.Send( NULL, NotificationSystemRPC.Create, true, sendTo );
 		}
 		else
@@ -71,6 +61,19 @@ modded class NotificationSystem
 		#endif
 	}
 
+	//! Serializes the notification, the RPC can then be sent to any number of players
+	static ScriptRPC Expansion_CreateRPC( StringLocaliser title, StringLocaliser text, string icon, int color, float time )
+	{
+		ScriptRPC rpc = new ScriptRPC();
+		rpc.Write( title );
+		rpc.Write( text );
+		rpc.Write( icon );
+		rpc.Write( color );
+		rpc.Write( time );
+
+		return rpc;
+	}
+
 	autoptr array< ref NotificationRuntimeData > m_ExNotifications;
 
 	void NotificationSystem()
@@ -153,19 +156,23 @@ modded class NotificationSystem
 		
 		if ( m_Instance && IsMissionClient() )
 		{
-			array< NotificationRuntimeData > to_remove = new array< NotificationRuntimeData >;
-			foreach ( NotificationRuntimeData data : m_Instance.m_ExNotifications )
+			float time = GetGame().GetTickTime();
+
+			//! Oldest first so the removed callbacks fire in the order the notifications were added
+			int i = 0;
+			while ( i < m_Instance.m_ExNotifications.Count() )
 			{
-				if ( data.GetTime() < GetGame().GetTickTime() && data.m_HasShown )
+				NotificationRuntimeData data = m_Instance.m_ExNotifications[i];
+				if ( data.GetTime() < time && data.m_HasShown )
 				{
-					to_remove.Insert( data );
+					//! The next notification moves into this index
+					m_Instance.m_ExNotifications.RemoveOrdered( i );
+					m_Instance.m_OnNotificationRemoved.Invoke( data );
+				}
+				else
+				{
+					i++;
 				}
-			}
-			
-			foreach ( NotificationRuntimeData removed : to_remove )
-			{
-				m_Instance.m_ExNotifications.RemoveItem( removed );
-				m_Instance.m_OnNotificationRemoved.Invoke( removed );
 			}
 		}
 		
@@ -35,6 +35,11 @@ modded class LoadingScreen
 	
 	protected CURLCore m_ExpansionCURLCore;
 
+	//! Progress of the mapping being spawned, set by ExpansionWorldMappingModule
+	protected static LoadingScreen s_ExpansionLoadingScreen;
+	protected static bool s_ExpansionMappingLoading;
+	protected static float s_ExpansionMappingProgress;
+
 	// ------------------------------------------------------------
 	// LoadingScreen Constructor
 	// ------------------------------------------------------------
@@ -53,6 +58,8 @@ modded class LoadingScreen
 
 		m_DayZGame = game;
 
+		s_ExpansionLoadingScreen = this;
+
 		m_WidgetRoot = game.GetLoadingWorkspace().CreateWidgets("DayZExpansion/GUI/layouts/expansion_loading.layout");
 
 		Class.CastTo(m_ImageLogoMid, m_WidgetRoot.FindAnyWidget("ImageLogoMid"));
@@ -141,6 +148,9 @@ modded class LoadingScreen
 	{
 		if(m_ExpansionCURLCore)
 			DestroyCURLCore();
+
+		if ( s_ExpansionLoadingScreen == this )
+			s_ExpansionLoadingScreen = NULL;
 	}
 
 	// ------------------------------------------------------------
@@ -282,15 +292,52 @@ modded class LoadingScreen
 			}
 		}
 
+		ExpansionUpdateMappingProgress();
+
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("LoadingScreen::Show - End");
 		#endif
 	}
 
+	// ------------------------------------------------------------
+	// Expansion ExpansionSetMappingProgress
+	// ------------------------------------------------------------
+	static void ExpansionSetMappingProgress( bool loading, float progress )
+	{
+		s_ExpansionMappingLoading = loading;
+		s_ExpansionMappingProgress = progress;
+
+		if ( s_ExpansionLoadingScreen )
+			s_ExpansionLoadingScreen.ExpansionUpdateMappingProgress();
+	}
+
+	// ------------------------------------------------------------
+	// Expansion ExpansionUpdateMappingProgress
+	// Only shown while the loading screen is visible, the progress text is hidden again afterwards
+	// ------------------------------------------------------------
+	protected void ExpansionUpdateMappingProgress()
+	{
+		if ( !m_WidgetRoot || !m_WidgetRoot.IsVisible() || !m_ProgressText )
+			return;
+
+		if ( !s_ExpansionMappingLoading )
+		{
+			string tmp;
+			m_ProgressText.SetText( "" );
+			m_ProgressText.Show( GetGame() && GetGame().CommandlineGetParam( "loadingTest", tmp ) );
+			return;
+		}
+
+		int percent = s_ExpansionMappingProgress * 100;
+		m_ProgressText.SetText( "Mapping " + percent.ToString() + "%" );
+		m_ProgressText.Show( true );
+	}
+
 	// ------------------------------------------------------------
 	// Expansion GetClientExpansionVersion
+	// Version of the loaded DayZ Expansion mod
 	// ------------------------------------------------------------
-   	string GetClientExpansionVersion()
+   	static string GetClientExpansionVersion()
 	{
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("LoadingScreen::GetClientExpansionVersion - Start");
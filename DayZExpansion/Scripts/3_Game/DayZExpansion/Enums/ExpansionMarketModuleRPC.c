@@ -25,6 +25,8 @@ enum ExpansionMarketModuleRPC
 	LoadTraderData,
 	RequestItemData,
 	LoadItemData,
+	LoadTraderStock,
+	ExitTrader,
 	
 	// Admin
 	GiveMoney,
@@ -14,5 +14,6 @@ enum ExpansionMonitorRPC
 {
 	INVALID = 20300,
 	SyncStats,
+	SubscribeStats,
 	COUNT
 }
\ No newline at end of file
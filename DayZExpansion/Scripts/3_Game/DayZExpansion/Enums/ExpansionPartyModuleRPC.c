@@ -32,5 +32,6 @@ enum ExpansionPartyModuleRPC
 	
 	UpdateQuickMarker,
 	SyncQuickMarkers,
+	SyncQuickMarkerChanges,
 	COUNT
 }
\ No newline at end of file
@@ -14,6 +14,8 @@ enum ExpansionSettingsRPC
 {
 	INVALID = 30000,
 	ListToLoad,
+	//! Client asks for the settings it has no valid cached copy of
+	Request,
 	
 	Book,
 	General,
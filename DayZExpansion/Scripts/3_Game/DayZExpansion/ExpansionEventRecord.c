@@ -0,0 +1,67 @@
+/**
+ * ExpansionEventRecord.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2020 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionEventRecord
+ * @brief		One line of the event stream written by ExpansionLogger.Event,
+ *				each record is serialized to a single line of JSON (NDJSON).
+ *				type tells which record class the line can be read back into.
+ **/
+class ExpansionEventRecord
+{
+	string type;
+
+	//! Filled by ExpansionLogger, "YYYY-MM-DD hh:mm:ss"
+	string time;
+}
+
+class ExpansionMarketEventRecord: ExpansionEventRecord
+{
+	static const string PURCHASE = "purchase";
+	static const string SELL = "sell";
+
+	string uid;
+	string item;
+	int quantity;
+	int price;
+	string zone;
+
+	void ExpansionMarketEventRecord( string recordType = "", string playerUID = "", string className = "", int amount = 0, int totalPrice = 0, string zoneName = "" )
+	{
+		type = recordType;
+		uid = playerUID;
+		item = className;
+		quantity = amount;
+		price = totalPrice;
+		zone = zoneName;
+	}
+}
+
+class ExpansionKillEventRecord: ExpansionEventRecord
+{
+	static const string KILL = "kill";
+
+	string uid;
+	string cause;
+	string killer;
+	string weapon;
+	float distance;
+
+	void ExpansionKillEventRecord( string victimUID = "", string killCause = "", string killerUID = "", string weaponClassName = "", float killDistance = 0 )
+	{
+		type = KILL;
+		uid = victimUID;
+		cause = killCause;
+		killer = killerUID;
+		weapon = weaponClassName;
+		distance = killDistance;
+	}
+}
@@ -0,0 +1,188 @@
+/**
+ * ExpansionLogSink.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2020 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionLogSink
+ * @brief		One log file of ExpansionLogger. Lines are kept in a preallocated buffer and
+ *				appended to the file in one go once the buffer is full, when ExpansionLogger
+ *				flushes on its timer or when the logger is destroyed.
+ *				A new part of the file is started once it reaches MAX_FILE_SIZE.
+ **/
+class ExpansionLogSink
+{
+	//! Lines kept before the buffer is written to the file
+	static const int BUFFER_SIZE = 64;
+
+	//! Bytes after which a new part of the file is started
+	static const int MAX_FILE_SIZE = 10485760;
+
+	protected string m_Folder;
+	protected string m_Prefix;
+	protected string m_Extension;
+
+	protected string m_DateTime;
+	protected string m_File;
+	protected int m_FilePart;
+	protected int m_FileSize;
+
+	protected autoptr TStringArray m_Buffer;
+	protected int m_Count;
+
+	// ------------------------------------------------------------
+	// ExpansionLogSink Constructor
+	// ------------------------------------------------------------
+	void ExpansionLogSink( string folder, string prefix, string extension = ".log" )
+	{
+		m_Folder = folder;
+		m_Prefix = prefix;
+		m_Extension = extension;
+
+		m_Buffer = new TStringArray;
+		m_Buffer.Resize( BUFFER_SIZE );
+		m_Count = 0;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionLogSink Start
+	// Buffered lines and the ones written from now on go to a new file named after dateTime
+	// ------------------------------------------------------------
+	void Start( string dateTime )
+	{
+		m_DateTime = dateTime;
+		m_FilePart = 0;
+
+		OpenPart();
+
+		Flush();
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionLogSink GetFile
+	// ------------------------------------------------------------
+	string GetFile()
+	{
+		return m_File;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionLogSink Write
+	// ------------------------------------------------------------
+	void Write( string line )
+	{
+		m_Buffer[m_Count] = line;
+		m_Count++;
+
+		if ( m_Count >= BUFFER_SIZE )
+			Flush();
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionLogSink Flush
+	// ------------------------------------------------------------
+	void Flush()
+	{
+		if ( m_Count == 0 )
+			return;
+
+		//! The logger wasn't initialised, start the file with the first lines
+		if ( m_File == "" )
+		{
+			m_DateTime = ExpansionLogger.GetDateTime();
+			m_FilePart = 0;
+
+			OpenPart();
+		}
+
+		int fileLog = OpenFile( m_File, FileMode.APPEND );
+		if ( fileLog == 0 )
+		{
+			//! Nothing can be done about these lines, don't let them block the next ones
+			m_Count = 0;
+			return;
+		}
+
+		for ( int i = 0; i < m_Count; i++ )
+		{
+			//! Line end included
+			int length = m_Buffer[i].Length() + 2;
+
+			if ( m_FileSize > 0 && m_FileSize + length > MAX_FILE_SIZE )
+			{
+				CloseFile( fileLog );
+
+				m_FilePart++;
+				OpenPart();
+
+				fileLog = OpenFile( m_File, FileMode.APPEND );
+				if ( fileLog == 0 )
+				{
+					m_Count = 0;
+					return;
+				}
+			}
+
+			FPrintln( fileLog, m_Buffer[i] );
+			m_FileSize += length;
+		}
+
+		CloseFile( fileLog );
+
+		m_Count = 0;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionLogSink OpenPart
+	// ------------------------------------------------------------
+	protected void OpenPart()
+	{
+		if ( !FileExist( m_Folder ) )
+		{
+			MakeDirectory( m_Folder );
+		}
+
+		m_File = m_Folder + m_Prefix + "_" + m_DateTime;
+		if ( m_FilePart > 0 )
+			m_File += "_" + m_FilePart.ToString();
+
+		m_File += m_Extension;
+
+		m_FileSize = 0;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionLogSink ClearEmptyLogs
+	// Deletes the files of the folder which start with an empty line, only the first line is read
+	// ------------------------------------------------------------
+	static void ClearEmptyLogs( string folder )
+	{
+		if ( !FileExist( folder ) )
+			return;
+
+		TStringArray files = FindFilesInLocation( folder );
+
+		for ( int i = 0; i < files.Count(); i++ )
+		{
+			string path = folder + files[i];
+
+			int fileLog = OpenFile( path, FileMode.READ );
+			if ( fileLog == 0 )
+				continue;
+
+			string line;
+			bool isEmpty = FGets( fileLog, line ) <= 0;
+
+			CloseFile( fileLog );
+
+			if ( isEmpty )
+				DeleteFile( path );
+		}
+	}
+}
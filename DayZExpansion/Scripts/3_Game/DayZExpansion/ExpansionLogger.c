@@ -12,12 +12,56 @@
 
 class ExpansionLogger
 {
-	private string m_ChatLogFile;
-	private string m_MarketLogFile;
-	private string m_KillFeedLogFile;
+	//! Interval at which the buffered lines are written to the log files
+	static const int FLUSH_INTERVAL = 5000;
+
+	private autoptr ExpansionLogSink m_ChatLog;
+	private autoptr ExpansionLogSink m_MarketLog;
+	private autoptr ExpansionLogSink m_KillFeedLog;
+	private autoptr ExpansionLogSink m_EventLog;
+
+	private static autoptr JsonSerializer s_EventSerializer = new JsonSerializer;
+
+	//! GetDateTime result of the current second
+	private int m_TimestampSecond;
+	private string m_Timestamp;
+	private string m_EventTimestamp;
+	
+	void ExpansionLogger()
+	{
+		m_ChatLog = new ExpansionLogSink( EXPANSION_CHAT_LOG_FOLDER, "Chat" );
+		m_MarketLog = new ExpansionLogSink( EXPANSION_MARKET_LOG_FOLDER, "Market" );
+		m_KillFeedLog = new ExpansionLogSink( EXPANSION_KILLFEED_LOG_FOLDER, "KillFeed" );
+		m_EventLog = new ExpansionLogSink( EXPANSION_EVENTS_LOG_FOLDER, "Events", EXPANSION_EVENTS_LOG_EXT );
+
+		m_TimestampSecond = -1;
+
+		//! The sinks create their own folder, not the ones above it
+		if ( !FileExist( EXPANSION_FOLDER ) )
+		{
+			MakeDirectory( EXPANSION_FOLDER );
+		}
+
+		if ( !FileExist( EXPANSION_LOG_FOLDER ) )
+		{
+			MakeDirectory( EXPANSION_LOG_FOLDER );
+		}
+
+		if ( GetGame() )
+		{
+			GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).CallLater( Flush, FLUSH_INTERVAL, true );
+		}
+	}
 		
 	void ~ExpansionLogger()
 	{
+		if ( GetGame() )
+		{
+			GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).Remove( Flush );
+		}
+
+		Flush();
+
 		ClearLogs();
 	}
 	
@@ -26,108 +70,27 @@ class ExpansionLogger
 		ClearMarketLogs();
 		ClearChatLogs();
 		ClearKillFeedLogs();
+		ClearEventLogs();
 	}
 	
 	void ClearMarketLogs()
 	{
-		if ( FileExist( EXPANSION_MARKET_LOG_FOLDER ) )
-		{
-			ref array<string> market_log_files = new array<string>;
-			market_log_files = FindFilesInLocation(EXPANSION_MARKET_LOG_FOLDER);
-			if ( market_log_files.Count() > 0 )
-			{
-				for ( int i = 0; i < market_log_files.Count(); i++ )
-				{
-					int marketFileLog = OpenFile( market_log_files[i], FileMode.READ );
-					bool deleteFile = false;
-					if ( marketFileLog != 0 )
-					{
-						ref array<string> market_log_lines = new array<string>;
-						string market_line_content;
-						while ( FGets( marketFileLog, market_line_content ) > 0 )
-						{
-							market_log_lines.Insert( market_line_content );
-						}
-						
-						if ( market_log_lines.Count() == 0 || !market_log_lines || market_log_lines == NULL )
-							deleteFile = true;
-					}
-					
-					CloseFile( marketFileLog );
-					
-					if ( deleteFile )
-						DeleteFile( market_log_files[i] );
-				}
-			}
-		}
+		ExpansionLogSink.ClearEmptyLogs( EXPANSION_MARKET_LOG_FOLDER );
 	}
 	
 	void ClearChatLogs()
 	{
-		if ( FileExist( EXPANSION_CHAT_LOG_FOLDER ) )
-		{
-			ref array<string> chat_log_files = new array<string>;
-			chat_log_files = FindFilesInLocation(EXPANSION_CHAT_LOG_FOLDER);
-			if ( chat_log_files.Count() > 0 )
-			{
-				for ( int i = 0; i < chat_log_files.Count(); i++ )
-				{
-					int chatFileLog = OpenFile( chat_log_files[i], FileMode.READ );
-					bool deleteFile = false;
-					if ( chatFileLog != 0 )
-					{
-						ref array<string> chat_log_lines = new array<string>;
-						string chat_line_content;
-						while ( FGets( chatFileLog, chat_line_content ) > 0 )
-						{
-							chat_log_lines.Insert( chat_line_content );
-						}
-						
-						if ( chat_log_lines.Count() == 0 || !chat_log_lines || chat_log_lines == NULL )
-							deleteFile = true;
-					}
-					
-					CloseFile( chatFileLog );
-					
-					if ( deleteFile )
-						DeleteFile( chat_log_files[i] );
-				}
-			}
-		}
+		ExpansionLogSink.ClearEmptyLogs( EXPANSION_CHAT_LOG_FOLDER );
 	}
 	
 	void ClearKillFeedLogs()
 	{
-		if ( FileExist( EXPANSION_KILLFEED_LOG_FOLDER ) )
-		{
-			ref array<string> killfeed_log_files = new array<string>;
-			killfeed_log_files = FindFilesInLocation(EXPANSION_KILLFEED_LOG_FOLDER);
-			if ( killfeed_log_files.Count() > 0 )
-			{
-				for ( int i = 0; i < killfeed_log_files.Count(); i++ )
-				{
-					int killfeedFileLog = OpenFile( killfeed_log_files[i], FileMode.READ );
-					bool deleteFile = false;
-					if ( killfeedFileLog != 0 )
-					{
-						ref array<string> killfeed_log_lines = new array<string>;
-						string killfeed_line_content;
-						while ( FGets( killfeedFileLog, killfeed_line_content ) > 0 )
-						{
-							killfeed_log_lines.Insert( killfeed_line_content );
-						}
-						
-						if ( killfeed_log_lines.Count() == 0 || !killfeed_log_lines || killfeed_log_lines == NULL )
-							deleteFile = true;
-					}
-					
-					CloseFile( killfeedFileLog );
-					
-					if ( deleteFile )
-						DeleteFile( killfeed_log_files[i] );
-				}
-			}
-		}
+		ExpansionLogSink.ClearEmptyLogs( EXPANSION_KILLFEED_LOG_FOLDER );
+	}
+	
+	void ClearEventLogs()
+	{
+		ExpansionLogSink.ClearEmptyLogs( EXPANSION_EVENTS_LOG_FOLDER );
 	}
 	
 	// ------------------------------------------------------------
@@ -147,10 +110,12 @@ class ExpansionLogger
 		ClearMarketLogs();
 		ClearChatLogs();
 		ClearKillFeedLogs();
+		ClearEventLogs();
 		
 		CreateNewChatLog();
 		CreateNewMarketLog();
 		CreateNewKillFeedLog();
+		CreateNewEventLog();
 		
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("ExpansionLogger::Init - End");
@@ -162,26 +127,7 @@ class ExpansionLogger
 	// ------------------------------------------------------------	
 	void CreateNewChatLog()
 	{
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionLogger::CreateNewChatLog - Start");
-		#endif
-		
-		if ( !FileExist( EXPANSION_CHAT_LOG_FOLDER ) )
-		{
-			MakeDirectory( EXPANSION_CHAT_LOG_FOLDER );
-		}
-
-		m_ChatLogFile = (EXPANSION_CHAT_LOG_FOLDER + "Chat_" + GetDateTime() + ".log");
-		int fileLog = OpenFile( m_ChatLogFile, FileMode.WRITE );
-		
-		if ( fileLog != 0 )
-		{
-			CloseFile( fileLog );
-		}
-		
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionLogger::CreateNewChatLog - End");
-		#endif
+		m_ChatLog.Start( GetDateTime() );
 	}
 	
 	// ------------------------------------------------------------
@@ -189,26 +135,7 @@ class ExpansionLogger
 	// ------------------------------------------------------------	
 	void CreateNewMarketLog()
 	{
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionLogger::CreateNewChatLog - Start");
-		#endif
-		
-		if ( !FileExist( EXPANSION_MARKET_LOG_FOLDER ) )
-		{
-			MakeDirectory( EXPANSION_MARKET_LOG_FOLDER );
-		}
-
-		m_MarketLogFile = (EXPANSION_MARKET_LOG_FOLDER + "Market_" + GetDateTime() + ".log");
-		int fileLog = OpenFile( m_MarketLogFile, FileMode.WRITE );
-		
-		if ( fileLog != 0 )
-		{
-			CloseFile( fileLog );
-		}
-		
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionLogger::CreateNewChatLog - End");
-		#endif
+		m_MarketLog.Start( GetDateTime() );
 	}
 	
 	// ------------------------------------------------------------
@@ -216,32 +143,32 @@ class ExpansionLogger
 	// ------------------------------------------------------------	
 	void CreateNewKillFeedLog()
 	{
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionLogger::CreateNewKillFeedLog - Start");
-		#endif
-		
-		if ( !FileExist( EXPANSION_KILLFEED_LOG_FOLDER ) )
-		{
-			MakeDirectory( EXPANSION_KILLFEED_LOG_FOLDER );
-		}
-
-		m_KillFeedLogFile = (EXPANSION_KILLFEED_LOG_FOLDER + "KillFeed_" + GetDateTime() + ".log");
-		int fileLog = OpenFile( m_KillFeedLogFile, FileMode.WRITE );
-		
-		if ( fileLog != 0 )
-		{
-			CloseFile( fileLog );
-		}
-		
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionLogger::CreateNewKillFeedLog - End");
-		#endif
+		m_KillFeedLog.Start( GetDateTime() );
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion CreateNewEventLog
+	// ------------------------------------------------------------	
+	void CreateNewEventLog()
+	{
+		m_EventLog.Start( GetDateTime() );
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion Flush
+	// ------------------------------------------------------------
+	void Flush()
+	{
+		m_ChatLog.Flush();
+		m_MarketLog.Flush();
+		m_KillFeedLog.Flush();
+		m_EventLog.Flush();
 	}
 	
 	// ------------------------------------------------------------
 	// Expansion GetDateTime
 	// ------------------------------------------------------------
-	private string GetDateTime()
+	static string GetDateTime()
 	{
 		int year, month, day;
 		int hour, minute, second;
@@ -255,16 +182,59 @@ class ExpansionLogger
 	}
 	
 	// ------------------------------------------------------------
-	// Expansion ChatLog
+	// Expansion GetTimestamp
+	// GetDateTime, only rebuilt once per second
 	// ------------------------------------------------------------
-	void ChatLog( string text )
+	private string GetTimestamp()
 	{
-		int chatFileLog = OpenFile( m_ChatLogFile, FileMode.APPEND );
-		if ( chatFileLog != 0 )
+		UpdateTimestamps();
+
+		return m_Timestamp;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion GetEventTimestamp
+	// "YYYY-MM-DD hh:mm:ss", sortable and split by hour with a Substring
+	// ------------------------------------------------------------
+	private string GetEventTimestamp()
+	{
+		UpdateTimestamps();
+
+		return m_EventTimestamp;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion UpdateTimestamps
+	// ------------------------------------------------------------
+	private void UpdateTimestamps()
+	{
+		if ( GetGame() )
 		{
-			FPrintln( chatFileLog, text );
-			CloseFile( chatFileLog );
+			int now = GetGame().GetTickTime();
+			if ( now == m_TimestampSecond )
+				return;
+
+			m_TimestampSecond = now;
 		}
+
+		int year, month, day;
+		int hour, minute, second;
+		GetYearMonthDay( year, month, day );
+		GetHourMinuteSecond( hour, minute, second );
+
+		string date = day.ToStringLen( 2 ) + "-" + month.ToStringLen( 2 ) + "-" + year.ToStringLen( 2 );
+		string time = hour.ToStringLen( 2 ) + "-" + minute.ToStringLen( 2 ) + "-" + second.ToStringLen( 2 );
+		m_Timestamp = date + "_" + time;
+
+		m_EventTimestamp = year.ToString() + "-" + month.ToStringLen( 2 ) + "-" + day.ToStringLen( 2 ) + " " + hour.ToStringLen( 2 ) + ":" + minute.ToStringLen( 2 ) + ":" + second.ToStringLen( 2 );
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion ChatLog
+	// ------------------------------------------------------------
+	void ChatLog( string text )
+	{
+		m_ChatLog.Write( text );
 	}
 	
 	// ------------------------------------------------------------
@@ -272,12 +242,7 @@ class ExpansionLogger
 	// ------------------------------------------------------------
 	void MarketLog( string text )
 	{
-		int marketFileLog = OpenFile( m_MarketLogFile, FileMode.APPEND );
-		if ( marketFileLog != 0 )
-		{
-			FPrintln( marketFileLog, "[Market]::[" + GetDateTime() + "] " + text );
-			CloseFile( marketFileLog );
-		}
+		m_MarketLog.Write( "[Market]::[" + GetTimestamp() + "] " + text );
 	}
 	
 	// ------------------------------------------------------------
@@ -285,12 +250,20 @@ class ExpansionLogger
 	// ------------------------------------------------------------
 	void KillFeedLog( string text )
 	{
-		int killFeedFileLog = OpenFile( m_KillFeedLogFile, FileMode.APPEND );
-		if ( killFeedFileLog != 0 )
-		{
-			FPrintln( killFeedFileLog, "[KillFeed]::[" + GetDateTime() + "] " + text );
-			CloseFile( killFeedFileLog );
-		}
+		m_KillFeedLog.Write( "[KillFeed]::[" + GetTimestamp() + "] " + text );
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion Event
+	// Adds the record to the event stream, one line of JSON per record
+	// ------------------------------------------------------------
+	void Event( ExpansionEventRecord record )
+	{
+		record.time = GetEventTimestamp();
+
+		string line;
+		if ( s_EventSerializer.WriteToString( record, false, line ) )
+			m_EventLog.Write( line );
 	}
 }
 
@@ -66,6 +66,13 @@ class ExpansionBaseBuildingSettings: ExpansionSettingBase
 		EXPrint("ExpansionBaseBuildingSettings::HandleRPC - Start");
 		#endif
 		
+		int hash;
+		if ( !ctx.Read( hash ) )
+		{
+			Error("ExpansionBaseBuildingSettings::HandleRPC hash");
+			return;
+		}
+
 		ExpansionBaseBuildingSettings setting;
 		if ( !ctx.Read( setting ) )
 		{
@@ -74,6 +81,9 @@ class ExpansionBaseBuildingSettings: ExpansionSettingBase
 		}
 
 		CopyInternal( setting );
+
+		if ( OnReceive( hash ) )
+			ExpansionSettingSerializer< ExpansionBaseBuildingSettings >.WriteCache( GetCacheFile(), hash, setting );
 		
 		m_IsLoaded = true;
 
@@ -99,6 +109,7 @@ class ExpansionBaseBuildingSettings: ExpansionSettingBase
 		ref ExpansionBaseBuildingSettings thisSetting = this;
 		
 		ScriptRPC rpc = new ScriptRPC;
+		rpc.Write( m_Hash );
 		rpc.Write( thisSetting );
 		rpc.Send( null, ExpansionSettingsRPC.BaseBuilding, true, identity );
 		
@@ -109,6 +120,12 @@ class ExpansionBaseBuildingSettings: ExpansionSettingBase
 		return 0;
 	}
 
+	// ------------------------------------------------------------
+	override void UpdateHash()
+	{
+		m_Hash = ExpansionSettingSerializer< ExpansionBaseBuildingSettings >.Hash( this );
+	}
+
 	// ------------------------------------------------------------
     override bool Copy( ExpansionSettingBase setting )
     {
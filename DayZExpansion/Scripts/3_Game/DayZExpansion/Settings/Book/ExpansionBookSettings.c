@@ -51,6 +51,14 @@ class ExpansionBookSettings: ExpansionSettingBase
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("ExpansionBookSettings::HandleRPC - Start");
 		#endif
+
+		int hash;
+		if ( !ctx.Read( hash ) )
+		{
+			Error("ExpansionBookSettings::HandleRPC hash");
+			return;
+		}
+
 		ExpansionBookSettings setting;
 		if ( !ctx.Read( setting ) )
 		{
@@ -60,6 +68,9 @@ class ExpansionBookSettings: ExpansionSettingBase
 
 		CopyInternal( setting );
 
+		if ( OnReceive( hash ) )
+			ExpansionSettingSerializer< ExpansionBookSettings >.WriteCache( GetCacheFile(), hash, setting );
+
 		m_IsLoaded = true;
 
 		ExpansionSettings.SI_Book.Invoke();
@@ -84,6 +95,7 @@ class ExpansionBookSettings: ExpansionSettingBase
 		ref ExpansionBookSettings thisSetting = this;
 		
 		ScriptRPC rpc = new ScriptRPC;
+		rpc.Write( m_Hash );
 		rpc.Write( thisSetting );
 		rpc.Send( null, ExpansionSettingsRPC.Book, true, identity );
 		
@@ -93,6 +105,12 @@ class ExpansionBookSettings: ExpansionSettingBase
 		return 0;
 	}
 
+	// ------------------------------------------------------------
+	override void UpdateHash()
+	{
+		m_Hash = ExpansionSettingSerializer< ExpansionBookSettings >.Hash( this );
+	}
+
 	// ------------------------------------------------------------
     override bool Copy( ExpansionSettingBase setting )
     {
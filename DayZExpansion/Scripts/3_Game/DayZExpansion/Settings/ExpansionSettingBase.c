@@ -1,5 +1,13 @@
 class ExpansionSettingBase
 {
+	//! Hash of the networked content, computed on the server when loaded and sent along with the setting
+	[NonSerialized()]
+	protected int m_Hash;
+
+	//! Set while the setting is read back from the client cache, so it isn't written again
+	[NonSerialized()]
+	protected bool m_IsReadingCache;
+
 	void ExpansionSettingBase()
 	{
 	}
@@ -80,6 +88,96 @@ class ExpansionSettingBase
 		Save();
 
 		if ( !IsMissionClient() )
+		{
+			UpdateHash();
 			Send( NULL );
+		}
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionSettingBase GetHash
+	// ------------------------------------------------------------
+	int GetHash()
+	{
+		return m_Hash;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionSettingBase UpdateHash
+	// Networked settings override this with ExpansionSettingSerializer
+	// ------------------------------------------------------------
+	void UpdateHash()
+	{
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionSettingBase GetCacheFile
+	// ------------------------------------------------------------
+	string GetCacheFile()
+	{
+		string name = ClassName();
+		name.ToLower();
+
+		return EXPANSION_CLIENT_SETTINGS_CACHE_FOLDER + name + ".bin";
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionSettingBase OnReceive
+	// Called by HandleRPC once the setting received from the server is copied,
+	// returns true when the received setting has to be written to the client cache
+	// Called on client
+	// ------------------------------------------------------------
+	protected bool OnReceive( int hash )
+	{
+		m_Hash = hash;
+
+		if ( m_IsReadingCache || !GetGame().IsMultiplayer() )
+			return false;
+
+		if ( !FileExist( EXPANSION_FOLDER ) )
+			MakeDirectory( EXPANSION_FOLDER );
+
+		if ( !FileExist( EXPANSION_CLIENT_SETTINGS_CACHE_FOLDER ) )
+			MakeDirectory( EXPANSION_CLIENT_SETTINGS_CACHE_FOLDER );
+
+		return true;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionSettingBase LoadCache
+	// Reads the cached setting if it was cached with the given hash
+	// Called on client
+	// ------------------------------------------------------------
+	bool LoadCache( int hash )
+	{
+		string path = GetCacheFile();
+		if ( !FileExist( path ) )
+			return false;
+
+		FileSerializer file = new FileSerializer;
+		if ( !file.Open( path, FileMode.READ ) )
+			return false;
+
+		int cachedHash;
+		bool isValid = file.Read( cachedHash ) && cachedHash == hash;
+
+		file.Close();
+
+		if ( !isValid )
+			return false;
+
+		//! HandleRPC reads the hash itself
+		if ( !file.Open( path, FileMode.READ ) )
+			return false;
+
+		Unload();
+
+		m_IsReadingCache = true;
+		HandleRPC( file );
+		m_IsReadingCache = false;
+
+		file.Close();
+
+		return IsLoaded();
 	}
 }
\ No newline at end of file
@@ -0,0 +1,48 @@
+/**
+ * ExpansionSettingSerializer.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2020 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionSettingSerializer
+ * @brief		Hashes and caches networked settings by their concrete type,
+ *				the same way ScriptRPC serializes them when they are sent.
+ *				A cache file holds the hash followed by the setting, like the setting RPC.
+ **/
+class ExpansionSettingSerializer<Class T>
+{
+	// ------------------------------------------------------------
+	// ExpansionSettingSerializer Hash
+	// ------------------------------------------------------------
+	static int Hash( T setting )
+	{
+		string json;
+		JsonSerializer serializer = new JsonSerializer;
+		serializer.WriteToString( setting, false, json );
+
+		return json.Hash();
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionSettingSerializer WriteCache
+	// ------------------------------------------------------------
+	static bool WriteCache( string path, int hash, T setting )
+	{
+		FileSerializer file = new FileSerializer;
+		if ( !file.Open( path, FileMode.WRITE ) )
+			return false;
+
+		file.Write( hash );
+		file.Write( setting );
+
+		file.Close();
+
+		return true;
+	}
+}
@@ -40,6 +40,9 @@ class ExpansionSettings
 
 	protected ref TStringArray m_NetworkedSettings;
 	protected bool m_SettingsToLoadInitialSent;
+
+	//! Every setting, keyed by lowercase class name as in m_NetworkedSettings
+	protected ref map< string, ExpansionSettingBase > m_SettingsByName;
 	
 	// ------------------------------------------------------------
 	// ExpansionSettings Constructor
@@ -171,7 +174,11 @@ class ExpansionSettings
 		EXLogPrint( "ExpansionSettings: Loading " + setting.ClassName() );
 		#endif
 		
-		if ( setting.Load() )
+		bool loaded = setting.Load();
+
+		setting.UpdateHash();
+
+		if ( loaded )
 		{
 			#ifdef EXPANSIONEXLOGPRINT
 			EXLogPrint( "ExpansionSettings: Successfully Loaded " + setting.ClassName() );
@@ -316,6 +323,18 @@ class ExpansionSettings
 		
 		m_NetworkedSettings = new TStringArray;
 
+		m_SettingsByName = new map< string, ExpansionSettingBase >;
+		AddSetting( m_SettingsBook );
+		AddSetting( m_SettingsGeneral );
+		AddSetting( m_SettingsMap );
+		AddSetting( m_SettingsMarket );
+		AddSetting( m_SettingsMission );
+		AddSetting( m_SettingsParty );
+		AddSetting( m_SettingsSafeZone );
+		AddSetting( m_SettingsSpawn );
+		AddSetting( m_SettingsBaseBuilding );
+		AddSetting( m_SettingsTerritory );
+
 		if ( IsMissionClient() )
 		{
 			OnClientInit();
@@ -325,8 +344,29 @@ class ExpansionSettings
 		}
 	}
 	
+	// ------------------------------------------------------------
+	// Expansion AddSetting
+	// ------------------------------------------------------------
+	protected void AddSetting( ExpansionSettingBase setting )
+	{
+		string name = setting.ClassName();
+		name.ToLower();
+
+		m_SettingsByName.Insert( name, setting );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetSetting
+	// ------------------------------------------------------------
+	ExpansionSettingBase GetSetting( string name )
+	{
+		return m_SettingsByName.Get( name );
+	}
+
 	// ------------------------------------------------------------
 	// Expansion Send
+	// Sends the list of networked settings with their hashes,
+	// the client answers with ExpansionSettingsRPC.Request for the ones it has no cached copy of.
 	// Can only be called on the server.
 	// ------------------------------------------------------------
     void Send( notnull PlayerIdentity identity )
@@ -338,21 +378,17 @@ class ExpansionSettings
 		if ( IsMissionClient() )
 			return;
 
+		array< int > hashes = new array< int >;
+		for ( int i = 0; i < m_NetworkedSettings.Count(); i++ )
+		{
+			hashes.Insert( GetSetting( m_NetworkedSettings[i] ).GetHash() );
+		}
+
 		ScriptRPC rpc = new ScriptRPC;
 		rpc.Write( m_NetworkedSettings );
+		rpc.Write( hashes );
 		rpc.Send( NULL, ExpansionSettingsRPC.ListToLoad, true, identity );
 
-		m_SettingsBook.Send( identity );
-		m_SettingsGeneral.Send( identity );
-		m_SettingsMap.Send( identity );
-		#ifdef EXPANSION_MARKET
-		m_SettingsMarket.Send( identity );
-		#endif
-		m_SettingsParty.Send( identity );
-		m_SettingsSpawn.Send( identity );
-		m_SettingsBaseBuilding.Send( identity );
-		m_SettingsTerritory.Send( identity );
-
 		#ifdef EXPANSIONEXLOGPRINT
 		EXLogPrint("ExpansionSettings::SendSettings - End");
 		#endif
@@ -381,6 +417,16 @@ class ExpansionSettings
 
 				return true;
 			}
+
+			case ExpansionSettingsRPC.Request:
+			{
+				RPC_Request( ctx, sender, target );
+				#ifdef EXPANSIONEXPRINT
+				EXPrint("ExpansionSettings::OnRPC RPC_Request");
+				#endif
+
+				return true;
+			}
 			
 			case ExpansionSettingsRPC.Book:
 			{
@@ -480,7 +526,61 @@ class ExpansionSettings
 		if ( !ctx.Read( listToLoads ) )
 			return;
 
+		array< int > hashes = new array< int >;
+		if ( !ctx.Read( hashes ) || hashes.Count() != listToLoads.Count() )
+			return;
+
 		m_NetworkedSettings = listToLoads;
+
+		TStringArray request = new TStringArray;
+
+		for ( int i = 0; i < listToLoads.Count(); i++ )
+		{
+			ExpansionSettingBase setting = GetSetting( listToLoads[i] );
+			if ( !setting )
+				continue;
+
+			if ( setting.LoadCache( hashes[i] ) )
+			{
+				#ifdef EXPANSIONEXLOGPRINT
+				EXLogPrint( "ExpansionSettings: Loaded " + listToLoads[i] + " from cache" );
+				#endif
+
+				continue;
+			}
+
+			request.Insert( listToLoads[i] );
+		}
+
+		if ( request.Count() == 0 )
+			return;
+
+		ScriptRPC rpc = new ScriptRPC;
+		rpc.Write( request );
+		rpc.Send( NULL, ExpansionSettingsRPC.Request, true, NULL );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion RPC_Request
+	// Called on server
+	// ------------------------------------------------------------
+	private void RPC_Request( ref ParamsReadContext ctx, PlayerIdentity senderRPC, Object target )
+	{
+		if ( !IsMissionHost() || !senderRPC )
+			return;
+
+		TStringArray request = new TStringArray;
+		if ( !ctx.Read( request ) )
+			return;
+
+		for ( int i = 0; i < request.Count(); i++ )
+		{
+			//! Only the settings the client was told to load
+			if ( m_NetworkedSettings.Find( request[i] ) == -1 )
+				continue;
+
+			GetSetting( request[i] ).Send( senderRPC );
+		}
 	}
 	
 	// ------------------------------------------------------------
@@ -72,6 +72,13 @@ class ExpansionGeneralSettings: ExpansionSettingBase
 		EXPrint("ExpansionGeneralSettings::HandleRPC - Start");
 		#endif
 		
+		int hash;
+		if ( !ctx.Read( hash ) )
+		{
+			Error("ExpansionGeneralSettings::HandleRPC hash");
+			return;
+		}
+
 		ExpansionGeneralSettings setting;
 		if ( !ctx.Read( setting ) )
 		{
@@ -81,6 +88,9 @@ class ExpansionGeneralSettings: ExpansionSettingBase
 
 		CopyInternal( setting );
 
+		if ( OnReceive( hash ) )
+			ExpansionSettingSerializer< ExpansionGeneralSettings >.WriteCache( GetCacheFile(), hash, setting );
+
 		m_IsLoaded = true;
 
 		ExpansionSettings.SI_General.Invoke();
@@ -105,6 +115,7 @@ class ExpansionGeneralSettings: ExpansionSettingBase
 		ref ExpansionGeneralSettings thisSetting = this;
 		
 		ScriptRPC rpc = new ScriptRPC;
+		rpc.Write( m_Hash );
 		rpc.Write( thisSetting );
 		rpc.Send( null, ExpansionSettingsRPC.General, true, identity );
 		
@@ -114,6 +125,12 @@ class ExpansionGeneralSettings: ExpansionSettingBase
 		return 0;
 	}
 
+	// ------------------------------------------------------------
+	override void UpdateHash()
+	{
+		m_Hash = ExpansionSettingSerializer< ExpansionGeneralSettings >.Hash( this );
+	}
+
 	// ------------------------------------------------------------
     override bool Copy( ExpansionSettingBase setting )
     {
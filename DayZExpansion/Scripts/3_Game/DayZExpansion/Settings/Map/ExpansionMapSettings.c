@@ -53,6 +53,13 @@ class ExpansionMapSettings: ExpansionSettingBase
 		EXPrint("ExpansionMapSettings::HandleRPC - Start");
 		#endif
 		
+		int hash;
+		if ( !ctx.Read( hash ) )
+		{
+			Error("ExpansionMapSettings::HandleRPC hash");
+			return;
+		}
+
 		ExpansionMapSettings setting;
 		if ( !ctx.Read( setting ) )
 		{
@@ -62,6 +69,9 @@ class ExpansionMapSettings: ExpansionSettingBase
 
 		CopyInternal( setting );
 
+		if ( OnReceive( hash ) )
+			ExpansionSettingSerializer< ExpansionMapSettings >.WriteCache( GetCacheFile(), hash, setting );
+
 		m_IsLoaded = true;
 
 		ExpansionSettings.SI_Map.Invoke();
@@ -86,6 +96,7 @@ class ExpansionMapSettings: ExpansionSettingBase
 		ref ExpansionMapSettings thisSetting = this;
 		
 		ScriptRPC rpc = new ScriptRPC;
+		rpc.Write( m_Hash );
 		rpc.Write( thisSetting );
 		rpc.Send( null, ExpansionSettingsRPC.Map, true, identity );
 		
@@ -95,6 +106,12 @@ class ExpansionMapSettings: ExpansionSettingBase
 		return 0;
 	}
 
+	// ------------------------------------------------------------
+	override void UpdateHash()
+	{
+		m_Hash = ExpansionSettingSerializer< ExpansionMapSettings >.Hash( this );
+	}
+
 	// ------------------------------------------------------------
     override bool Copy( ExpansionSettingBase setting )
     {
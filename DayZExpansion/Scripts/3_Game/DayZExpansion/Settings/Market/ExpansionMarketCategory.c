@@ -20,6 +20,9 @@ class ExpansionMarketCategory
 
 	autoptr array< ref ExpansionMarketItem > Items = new array< ref ExpansionMarketItem >;
 
+	//! True when the category changed since the file was last written
+	protected bool m_IsDirty;
+
 	// ------------------------------------------------------------
 	// ExpansionMarketCategory Constructor
 	// ------------------------------------------------------------
@@ -106,7 +109,15 @@ class ExpansionMarketCategory
 
 			file.Close();
 			
-			settings.Save();
+			if ( settings.m_Version != 4 )
+			{
+				#ifdef EXPANSIONEXLOGPRINT
+				EXLogPrint( "[ExpansionMarketCategory] Old settings file, updating to newer version" );
+				#endif
+
+				settings.m_Version = 4;
+				settings.Save();
+			}
 			
 			#ifdef EXPANSIONEXLOGPRINT
 			EXLogPrint( "[ExpansionMarketCategory] Loaded settings file " + name );
@@ -132,8 +143,14 @@ class ExpansionMarketCategory
 		#endif
 		
 		FileSerializer file = new FileSerializer();
+
+		string path = EXPANSION_MARKET_FOLDER + m_FileName + ".bin";
+		string tempPath = path + ".tmp";
 		
-		if ( file.Open( EXPANSION_MARKET_FOLDER + m_FileName + ".bin", FileMode.WRITE ) )
+		//! Write to a temporary file first so an interrupted write never truncates the category file.
+		//! The copy over the category file is not verified like the trader zone stock, categories
+		//! are only written on admin edits and when the defaults are generated
+		if ( file.Open( tempPath, FileMode.WRITE ) )
 		{
 			// always overwrite with the latest version.
 
@@ -163,6 +180,13 @@ class ExpansionMarketCategory
 
 			file.Close();
 
+			if ( CopyFile( tempPath, path ) )
+			{
+				DeleteFile( tempPath );
+
+				m_IsDirty = false;
+			}
+
 			#ifdef EXPANSIONEXLOGPRINT
 			EXLogPrint("[ExpansionMarketCategory] Saved settings");
 			#endif
@@ -174,6 +198,23 @@ class ExpansionMarketCategory
 		}
 	}
 
+	// ------------------------------------------------------------
+	// Expansion IsDirty
+	// ------------------------------------------------------------
+	bool IsDirty()
+	{
+		return m_IsDirty;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion SetDirty
+	// Marks the category to be written on the next flush
+	// ------------------------------------------------------------
+	void SetDirty()
+	{
+		m_IsDirty = true;
+	}
+
 	// ------------------------------------------------------------
 	// Expansion Defaults
 	// ------------------------------------------------------------
@@ -226,6 +267,8 @@ class ExpansionMarketCategory
 
 		Items.Insert( item );
 
+		SetDirty();
+
 		return item;
 	}
 
@@ -249,19 +292,8 @@ class ExpansionMarketCategory
 
 		Items.Insert( item );
 
-		return item;
-	}
-
-	ref ExpansionMarketItem GetItem( string clsName )
-	{
-		for ( int i = 0; i < Items.Count(); i++ )
-		{
-			if ( Items[i].ClassName == clsName )
-			{
-				return Items[i];
-			}
-		}
+		SetDirty();
 
-		return NULL;
+		return item;
 	}
 }
\ No newline at end of file
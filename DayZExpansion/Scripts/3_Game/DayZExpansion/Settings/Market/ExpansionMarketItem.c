@@ -111,16 +111,70 @@ class ExpansionMarketItem
 			
 		if ( stock <= MinStockThreshold )
 			return MaxPriceThreshold;
-		
-		//return LinearConversion( MinStockThreshold, MaxStockThreshold, stock, MaxPriceThreshold, MinPriceThreshold, true );
 
-		float minStock = MinStockThreshold;
-		float maxStock = MaxStockThreshold;
-		float cStock = stock;
-		float pStock = ( cStock - minStock ) / ( maxStock - minStock );
+		return MinPriceThreshold + GetLinearPriceSum( stock, stock );
+	}
 
-		float nPriceDiff = ( 1.0 - pStock ) / ( MaxPriceThreshold - MinPriceThreshold );
-		
-		return MinPriceThreshold + ( ExpansionMarketCurrency ) nPriceDiff;
+	// ------------------------------------------------------------
+	// Expansion CalculatePriceRange
+	// Calculates the summed price of one item at each stock level from 'stockFrom' to 'stockTo' (both included),
+	// the stock levels between the thresholds are summed as an arithmetic series and rounded once
+	// ------------------------------------------------------------
+	ExpansionMarketCurrency CalculatePriceRange( int stockFrom, int stockTo )
+	{
+		if ( stockFrom > stockTo )
+			return 0;
+
+		int count = stockTo - stockFrom + 1;
+
+		if ( StaticPrice > 0 )
+			return count * StaticPrice;
+
+		if ( StaticStock )
+			return count * CalculatePrice( 1 );
+
+		//! No stock left, nothing to pay for
+		if ( stockTo <= 0 )
+			return 0;
+
+		if ( stockFrom < 1 )
+			stockFrom = 1;
+
+		ExpansionMarketCurrency total = 0;
+
+		//! Below the minimum stock, everything is at the maximum price. The maximum stock check comes first in CalculatePrice
+		int lowCount = Math.Min( stockTo, Math.Min( MinStockThreshold, MaxStockThreshold - 1 ) ) - stockFrom + 1;
+		if ( lowCount > 0 )
+			total += lowCount * MaxPriceThreshold;
+
+		//! Above the maximum stock, everything is at the minimum price
+		int highCount = stockTo - Math.Max( stockFrom, MaxStockThreshold ) + 1;
+		if ( highCount > 0 )
+			total += highCount * MinPriceThreshold;
+
+		int first = Math.Max( stockFrom, MinStockThreshold + 1 );
+		int last = Math.Min( stockTo, MaxStockThreshold - 1 );
+		if ( first <= last )
+			total += ( last - first + 1 ) * MinPriceThreshold + GetLinearPriceSum( first, last );
+
+		return total;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetLinearPriceSum
+	// Summed price above MinPriceThreshold of the stock levels 'first' to 'last' between the thresholds.
+	// The price goes down linearly from MaxPriceThreshold at MinStockThreshold to MinPriceThreshold
+	// at MaxStockThreshold, so the sum only needs the summed distance of the stock levels to MaxStockThreshold
+	// ------------------------------------------------------------
+	protected ExpansionMarketCurrency GetLinearPriceSum( int first, int last )
+	{
+		float count = last - first + 1;
+		float steps = 2 * MaxStockThreshold - first - last;
+		steps = count * steps * 0.5;
+
+		float priceRange = MaxPriceThreshold - MinPriceThreshold;
+		float stockRange = MaxStockThreshold - MinStockThreshold;
+
+		return Math.Round( steps * priceRange / stockRange );
 	}
 }
\ No newline at end of file
@@ -26,6 +26,10 @@ class ExpansionMarketSettings: ExpansionSettingBase
 	[NonSerialized()]
 	protected autoptr map< int, ref ExpansionMarketCategory > m_Categories;
 
+	//! Every market item of every category, keyed by lowercase class name
+	[NonSerialized()]
+	protected autoptr map< string, ExpansionMarketItem > m_MarketItems;
+
 	[NonSerialized()]
 	protected autoptr array< ref ExpansionMarketTraderZone > m_TraderZones;
 
@@ -47,6 +51,7 @@ class ExpansionMarketSettings: ExpansionSettingBase
 		NetworkCategories = new array< ref ExpansionMarketNetworkCategory >;
 
 		m_Categories = new map< int, ref ExpansionMarketCategory >;
+		m_MarketItems = new map< string, ExpansionMarketItem >;
 
 		m_TraderZones = new array< ref ExpansionMarketTraderZone >;
 		m_Traders = new array< ref ExpansionMarketTrader >;
@@ -89,6 +94,7 @@ class ExpansionMarketSettings: ExpansionSettingBase
 				if ( !m_Categories.Find( category.CategoryID, matchingCategory ) )
 				{
 					m_Categories.Set( category.CategoryID, category );
+					AddCategoryItems( category );
 
 					NetworkCategories.Insert( new ExpansionMarketNetworkCategory( category ) );
 				} else
@@ -128,6 +134,11 @@ class ExpansionMarketSettings: ExpansionSettingBase
 			if ( pos > -1 )
 			{
 				fileName = files[i].Substring( 0, pos );
+				fileType = files[i].Substring( pos, files[i].Length() - pos );
+
+				//! Skip the temporary and backup files of a save
+				if ( fileType != ".bin" )
+					continue;
 
 				m_TraderZones.Insert( ExpansionMarketTraderZone.Load( fileName ) );
 			}
@@ -176,6 +187,13 @@ class ExpansionMarketSettings: ExpansionSettingBase
 	{
 		//TraderPrint("ExpansionMarketSettings::HandleRPC - Start");
 		
+		int hash;
+		if ( !ctx.Read( hash ) )
+		{
+			Error("ExpansionMarketSettings::HandleRPC hash");
+			return;
+		}
+
 		ExpansionMarketSettings setting;
 		if ( !ctx.Read( setting ) )
 		{
@@ -185,6 +203,9 @@ class ExpansionMarketSettings: ExpansionSettingBase
 
 		CopyInternal( setting );
 
+		if ( OnReceive( hash ) )
+			ExpansionSettingSerializer< ExpansionMarketSettings >.WriteCache( GetCacheFile(), hash, setting );
+
 		m_IsLoaded = true;
 		
 		ExpansionSettings.SI_Market.Invoke();
@@ -205,6 +226,7 @@ class ExpansionMarketSettings: ExpansionSettingBase
 		ref ExpansionMarketSettings thisSetting = this;
 		
 		ScriptRPC rpc = new ScriptRPC;
+		rpc.Write( m_Hash );
 		rpc.Write( thisSetting );
 		rpc.Send( null, ExpansionSettingsRPC.Market, true, identity );
 		
@@ -212,6 +234,12 @@ class ExpansionMarketSettings: ExpansionSettingBase
 		return 0;
 	}
 
+	// ------------------------------------------------------------
+	override void UpdateHash()
+	{
+		m_Hash = ExpansionSettingSerializer< ExpansionMarketSettings >.Hash( this );
+	}
+
 	// ------------------------------------------------------------
 	override bool Copy( ExpansionSettingBase setting )
 	{
@@ -220,8 +248,27 @@ class ExpansionMarketSettings: ExpansionSettingBase
 			return false;
 
 		CopyInternal( s );
+
 		return true;
 	}
+
+	// ------------------------------------------------------------
+	override void Update( ExpansionSettingBase setting )
+	{
+		Copy( setting );
+
+		//! Edited by an admin on the server, the save writes every category like a full save did
+		if ( IsMissionHost() )
+			SetDirty();
+
+		Save();
+
+		if ( !IsMissionClient() )
+		{
+			UpdateHash();
+			Send( NULL );
+		}
+	}
 	
 	// ------------------------------------------------------------
 	private void CopyInternal( ref ExpansionMarketSettings s )
@@ -234,6 +281,8 @@ class ExpansionMarketSettings: ExpansionSettingBase
 		AirSpawnPositions.Copy( s.AirSpawnPositions );
 		WaterSpawnPositions.Copy( s.WaterSpawnPositions );
 
+		m_MarketItems.Clear();
+
 		for ( int i = 0; i < s.NetworkCategories.Count(); i++ )
 		{
 			ref ExpansionMarketCategory category = new ref ExpansionMarketCategory;
@@ -257,6 +306,7 @@ class ExpansionMarketSettings: ExpansionSettingBase
 			item = new ExpansionMarketItem( networkItem.CategoryID, clsName, -1, -1, -1, -1, -1 );
 
 			m_Categories.Get( item.CategoryID ).Items.Insert( item );
+			AddMarketItem( item );
 		}
 
 		//TraderPrint("ExpansionMarketSettings::UpdateMarketItem_Client - End");
@@ -272,10 +322,41 @@ class ExpansionMarketSettings: ExpansionSettingBase
 		category.Save();
 
 		m_Categories.Set( category.CategoryID, category );
+		AddCategoryItems( category );
 		
 		NetworkCategories.Insert( new ExpansionMarketNetworkCategory( category ) );
 	}
 
+	// ------------------------------------------------------------
+	// Expansion AddCategoryItems
+	// Adds the items of the category to the class name lookup
+	// ------------------------------------------------------------
+	protected void AddCategoryItems( ExpansionMarketCategory category )
+	{
+		for ( int i = 0; i < category.Items.Count(); i++ )
+		{
+			AddMarketItem( category.Items[i] );
+		}
+	}
+
+	// ------------------------------------------------------------
+	// Expansion AddMarketItem
+	// ------------------------------------------------------------
+	protected void AddMarketItem( ExpansionMarketItem item )
+	{
+		if ( !item )
+			return;
+
+		//! Class names are lowercase from here on, lookups never have to convert them again
+		string clsName = item.ClassName;
+		clsName.ToLower();
+		item.ClassName = clsName;
+
+		//! First category loaded wins when an item is in several of them
+		if ( !m_MarketItems.Contains( clsName ) )
+			m_MarketItems.Insert( clsName, item );
+	}
+
 	// ------------------------------------------------------------
 	protected void DefaultCategories()
 	{
@@ -484,56 +565,63 @@ class ExpansionMarketSettings: ExpansionSettingBase
 		
 		JsonFileLoader< ExpansionMarketSettings >.JsonSaveFile( EXPANSION_MARKET_SETTINGS, this );
 
+		//! Traders are written when created or upgraded and never change at runtime
+		SaveDirty();
+		
+		//TraderPrint("ExpansionMarketSettings::Save - End");
+
+		return true;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion SetDirty
+	// Marks every category and trader zone loaded from a file to be written on the next save
+	// ------------------------------------------------------------
+	void SetDirty()
+	{
 		for ( int i = 0; i < m_Categories.Count(); i++ )
 		{
-			if ( m_Categories.GetElement( i ) )
-				m_Categories.GetElement( i ).Save();
+			ExpansionMarketCategory category = m_Categories.GetElement( i );
+			if ( category && category.m_FileName != "" )
+				category.SetDirty();
 		}
 
 		for ( int j = 0; j < m_TraderZones.Count(); j++ )
 		{
-			m_TraderZones[j].Save();
+			m_TraderZones[j].SetDirty();
 		}
+	}
 
-		for ( int k = 0; k < m_Traders.Count(); k++ )
+	// ------------------------------------------------------------
+	// Expansion SaveDirty
+	// Writes only the categories and trader zones that changed
+	// since they were last written
+	// ------------------------------------------------------------
+	void SaveDirty()
+	{
+		for ( int i = 0; i < m_Categories.Count(); i++ )
 		{
-			m_Traders[k].Save();
+			ExpansionMarketCategory category = m_Categories.GetElement( i );
+			if ( category && category.IsDirty() )
+				category.Save();
 		}
-		
-		//TraderPrint("ExpansionMarketSettings::Save - End");
 
-		return true;
+		for ( int j = 0; j < m_TraderZones.Count(); j++ )
+		{
+			if ( m_TraderZones[j].IsDirty() )
+				m_TraderZones[j].Save();
+		}
 	}
 
+	// ------------------------------------------------------------
+	// Expansion GetItem
+	// Single lookup path for market items, the class name can be in any case
 	// ------------------------------------------------------------
 	bool GetItem( string clsName, out ExpansionMarketItem item )
 	{
-		//! TraderPrint("ExpansionMarketSettings::GetItem - Start");
-		
 		clsName.ToLower();
 
-		//! TraderPrint( "ExpansionMarketSettings::GetItem - Given class name is is: " + clsName );
-		//! TraderPrint( "ExpansionMarketSettings::GetItem - m_Categories count is: " + m_Categories.Count().ToString() );
-		
-		//! Print("_GetItem:: m_Categories count " + m_Categories.Count());
-		//! Print("_GetItem:: clsName " + clsName);
-
-		for ( int i = 0; i < m_Categories.Count(); i++ )
-		{
-			item = m_Categories.GetElement( i ).GetItem( clsName );
-			//! Print("_GetItem:: item " + item);
-			if ( item )
-			{
-				//! Print("_GetItem:: true");
-				//! TraderPrint("ExpansionMarketSettings::GetItem - Return true!");
-				return true;
-			}
-		}
-
-		//! Print("_GetItem:: false");
-
-		//! TraderPrint("ExpansionMarketSettings::GetItem - Return false!");
-		return false;
+		return m_MarketItems.Find( clsName, item );
 	}
 
 	// ------------------------------------------------------------
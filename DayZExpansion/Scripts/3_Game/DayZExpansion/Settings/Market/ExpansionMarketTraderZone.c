@@ -12,6 +12,9 @@
 
 class ExpansionMarketTraderZone
 {
+	//! Maximum amount of stock changes remembered for delta synchronisation
+	static const int STOCK_JOURNAL_MAX = 512;
+
 	int m_Version = 3;
 
 	string m_FileName;
@@ -24,6 +27,15 @@ class ExpansionMarketTraderZone
 
 	ref map< string, int > Stock;
 	ref map< string, int > ReservedStock;
+
+	//! Stock version and change journal, not persisted.
+	//! m_StockJournal[i] is the class name whose change produced version m_StockJournalStart + i + 1
+	protected int m_StockVersion;
+	protected int m_StockJournalStart;
+	protected ref array< string > m_StockJournal;
+
+	//! True when the stock changed since the file was last written
+	protected bool m_IsDirty;
 	
 	// ------------------------------------------------------------
 	// ExpansionMarketTraderZone Constructor
@@ -32,6 +44,8 @@ class ExpansionMarketTraderZone
 	{
 		Stock = new map< string, int >;
 		ReservedStock = new map< string, int >;
+
+		m_StockJournal = new array< string >;
 	}
 
 	void DebugPrint()
@@ -40,7 +54,6 @@ class ExpansionMarketTraderZone
 		for ( int i = 0 ; i < Stock.Count(); i++ )
 		{
 			string clsName = Stock.GetKey( i );
-			clsName.ToLower();
 			
 			//! Print( "Item " + clsName );
 			//! Print( " Stock " + Stock.Get( clsName ) );
@@ -64,6 +77,16 @@ class ExpansionMarketTraderZone
 
 		string path = EXPANSION_TRADER_ZONES_FOLDER + name + ".bin";
 
+		//! A backup left behind means the last save was interrupted before the new file was verified
+		if ( FileExist( path + ".bak" ) )
+		{
+			#ifdef EXPANSIONEXLOGPRINT
+			EXLogPrint( "[" + settings + "] Interrupted save, loading the previous settings file " + path + ".bak" );
+			#endif
+
+			path = path + ".bak";
+		}
+
 		if ( FileExist( path ) && file.Open( path, FileMode.READ ) )
 		{
 			// if we make any changes to how the data is stored, 
@@ -88,6 +111,7 @@ class ExpansionMarketTraderZone
 			file.Read( settings.Position );
 			file.Read( settings.Radius );
 
+			//! Stock keys are lowercased once here, all lookups after that expect lowercase class names
 			if ( settings.m_Version >= 3 )
 			{
 				int stockMapLength;
@@ -107,7 +131,17 @@ class ExpansionMarketTraderZone
 				}
 			} else
 			{
-				file.Read( settings.Stock );
+				map< string, int > oldStock = new map< string, int >;
+				file.Read( oldStock );
+
+				for ( int j = 0; j < oldStock.Count(); j++ )
+				{
+					string oldClassName = oldStock.GetKey( j );
+					oldClassName.ToLower();
+
+					settings.Stock.Insert( oldClassName, oldStock.GetElement( j ) );
+					settings.ReservedStock.Insert( oldClassName, 0 );
+				}
 			}
 
 			file.Close();
@@ -117,6 +151,7 @@ class ExpansionMarketTraderZone
 				EXLogPrint( "[" + settings + "] Old settings file, updating to newer version" );
 				#endif
 
+				settings.m_Version = maxversion;
 				settings.Save();
 			}
 
@@ -148,8 +183,11 @@ class ExpansionMarketTraderZone
 		FileSerializer file = new FileSerializer();
 		
 		string path = EXPANSION_TRADER_ZONES_FOLDER + m_FileName + ".bin";
+		string tempPath = path + ".tmp";
+		string backupPath = path + ".bak";
 		
-		if ( file.Open( path, FileMode.WRITE ) )
+		//! Write to a temporary file first so an interrupted save never truncates the stock file
+		if ( file.Open( tempPath, FileMode.WRITE ) )
 		{
 			// always overwrite with the latest version.
 			file.Write( m_Version );
@@ -169,9 +207,33 @@ class ExpansionMarketTraderZone
 
 			file.Close();
 
-			#ifdef EXPANSIONEXLOGPRINT
-			EXLogPrint("[" + this + "] Saved settings");
-			#endif
+			//! CopyFile overwrites in place and can be interrupted too, the previous file
+			//! is kept as a backup until the copy reads back completely
+			if ( FileExist( path ) && !CopyFile( path, backupPath ) )
+			{
+				#ifdef EXPANSIONEXLOGPRINT
+				EXLogPrint( "[" + this + "] Failed to back up settings file " + path );
+				#endif
+
+				return;
+			}
+
+			if ( CopyFile( tempPath, path ) && IsReadable( path, Stock.Count() ) )
+			{
+				DeleteFile( backupPath );
+				DeleteFile( tempPath );
+
+				m_IsDirty = false;
+
+				#ifdef EXPANSIONEXLOGPRINT
+				EXLogPrint("[" + this + "] Saved settings");
+				#endif
+			}
+			else if ( FileExist( backupPath ) && CopyFile( backupPath, path ) )
+			{
+				//! Still dirty, the next flush tries again
+				DeleteFile( backupPath );
+			}
 		} 
 		else
 		{
@@ -181,6 +243,56 @@ class ExpansionMarketTraderZone
 		}
 	}
 
+	// ------------------------------------------------------------
+	// Expansion IsReadable
+	// True if the file at path holds a complete zone with stockCount stock entries
+	// ------------------------------------------------------------
+	static bool IsReadable( string path, int stockCount )
+	{
+		FileSerializer file = new FileSerializer();
+		if ( !file.Open( path, FileMode.READ ) )
+			return false;
+
+		int version;
+		string zoneName;
+		string displayName;
+		vector position;
+		float radius;
+		int count;
+
+		bool success = file.Read( version ) && file.Read( zoneName ) && file.Read( displayName );
+		success = success && file.Read( position ) && file.Read( radius );
+		success = success && file.Read( count ) && count == stockCount;
+
+		for ( int i = 0; success && i < count; i++ )
+		{
+			string className;
+			int level;
+			success = file.Read( className ) && file.Read( level );
+		}
+
+		file.Close();
+
+		return success;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion IsDirty
+	// ------------------------------------------------------------
+	bool IsDirty()
+	{
+		return m_IsDirty;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion SetDirty
+	// Marks the zone to be written on the next flush
+	// ------------------------------------------------------------
+	void SetDirty()
+	{
+		m_IsDirty = true;
+	}
+
 	// ------------------------------------------------------------
 	// Expansion Defaults
 	// ------------------------------------------------------------
@@ -205,8 +317,8 @@ class ExpansionMarketTraderZone
 
 		for ( int i = 0 ; i < Stock.Count(); i++ )
 		{
+			//! Stock keys are lowercased on load
 			string className = Stock.GetKey( i );
-			className.ToLower();
 
 			if ( trader.ItemExists( className ) )
 			{
@@ -215,23 +327,7 @@ class ExpansionMarketTraderZone
 					continue;
 
 				ExpansionMarketNetworkItem item = new ExpansionMarketNetworkItem;
-
-				if ( mItem.StaticStock )
-				{
-					if ( Stock.Get( className ) == 1 )
-					{
-						item.Stock = -1; //! -1 is in stock
-					} 
-					else
-					{
-						item.Stock = -2; //! -2 is not in stock
-					}
-				} 
-				else
-				{
-					item.Stock = Stock.Get( className );// - ReservedStock.Get( className );
-				}
-
+				item.Stock = GetNetworkStock( className, mItem );
 				item.CategoryID = mItem.CategoryID;
 				item.ClassName = className;
 				list.Insert( item );
@@ -239,17 +335,107 @@ class ExpansionMarketTraderZone
 		}
 	}
 
+	// ------------------------------------------------------------
+	// Expansion GetNetworkStockDelta
+	// Fills className/stock pairs of every item of the trader whose
+	// stock changed after the given version.
+	// Returns false if the journal no longer reaches back to that
+	// version, in which case a full snapshot has to be sent.
+	// ------------------------------------------------------------
+	bool GetNetworkStockDelta( ExpansionMarketTrader trader, int version, out TStringArray classNames, out array< int > stocks )
+	{
+		if ( version < m_StockJournalStart || version > m_StockVersion )
+			return false;
+
+		if ( !classNames )
+			classNames = new TStringArray;
+		if ( !stocks )
+			stocks = new array< int >;
+
+		set< string > added = new set< string >;
+
+		for ( int i = version - m_StockJournalStart; i < m_StockJournal.Count(); i++ )
+		{
+			string className = m_StockJournal[i];
+
+			if ( added.Find( className ) > -1 || !trader.ItemExists( className ) )
+				continue;
+
+			ExpansionMarketItem mItem;
+			if ( !GetExpansionSettings().GetMarket().GetItem( className, mItem ) )
+				continue;
+
+			added.Insert( className );
+
+			classNames.Insert( className );
+			stocks.Insert( GetNetworkStock( className, mItem ) );
+		}
+
+		return true;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetNetworkStock
+	// ------------------------------------------------------------
+	protected int GetNetworkStock( string className, ExpansionMarketItem mItem )
+	{
+		if ( mItem.StaticStock )
+		{
+			if ( Stock.Get( className ) == 1 )
+				return -1; //! -1 is in stock
+
+			return -2; //! -2 is not in stock
+		}
+
+		return Stock.Get( className );// - ReservedStock.Get( className );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetStockVersion
+	// ------------------------------------------------------------
+	int GetStockVersion()
+	{
+		return m_StockVersion;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion OnStockChanged
+	// Bumps the stock version and records the change in the journal
+	// ------------------------------------------------------------
+	protected void OnStockChanged( string className )
+	{
+		m_IsDirty = true;
+
+		m_StockVersion++;
+		m_StockJournal.Insert( className );
+
+		if ( m_StockJournal.Count() <= STOCK_JOURNAL_MAX )
+			return;
+
+		//! Drop the oldest half, clients older than that get a full snapshot
+		int drop = STOCK_JOURNAL_MAX / 2;
+
+		array< string > journal = new array< string >;
+		for ( int i = drop; i < m_StockJournal.Count(); i++ )
+		{
+			journal.Insert( m_StockJournal[i] );
+		}
+
+		m_StockJournal = journal;
+		m_StockJournalStart += drop;
+	}
+
 	// ------------------------------------------------------------
 	// Expansion SetStock
 	// ------------------------------------------------------------
 	void SetStock( string className, int stock )
 	{
-		className.ToLower();
-
 		ExpansionMarketItem marketItem;
 		if ( !GetExpansionSettings().GetMarket().GetItem( className, marketItem ) )
 			return;
 
+		className = marketItem.ClassName;
+
 		if ( marketItem.StaticStock )
 			stock = 1;
 
@@ -266,6 +452,8 @@ class ExpansionMarketTraderZone
 			Stock.Insert( className, stock );
 			ReservedStock.Insert( className, 0 );
 		}
+
+		OnStockChanged( className );
 	}
 
 	// ------------------------------------------------------------
@@ -273,12 +461,12 @@ class ExpansionMarketTraderZone
 	// ------------------------------------------------------------
 	void ClearReservedStock( string className, int reserved )
 	{
-		className.ToLower();
-
 		ExpansionMarketItem marketItem;
 		if ( !GetExpansionSettings().GetMarket().GetItem( className, marketItem ) )
 			return;
 
+		className = marketItem.ClassName;
+
 		if ( !marketItem.StaticStock )
 		{
 			if ( ReservedStock.Contains( className ) )
@@ -296,12 +484,12 @@ class ExpansionMarketTraderZone
 	// ------------------------------------------------------------
 	void AddStock( string className, int stock )
 	{
-		className.ToLower();
-
 		ExpansionMarketItem marketItem;
 		if ( !GetExpansionSettings().GetMarket().GetItem( className, marketItem ) )
 			return;
 
+		className = marketItem.ClassName;
+
 		if ( marketItem.StaticStock )
 			stock = 1;
 
@@ -314,6 +502,8 @@ class ExpansionMarketTraderZone
 			Stock.Insert( className, stock );
 			ReservedStock.Insert( className, 0 );
 		}
+
+		OnStockChanged( className );
 	}
 
 	// ------------------------------------------------------------
@@ -322,8 +512,6 @@ class ExpansionMarketTraderZone
 	// ------------------------------------------------------------
 	void RemoveStock( string className, int stock, bool inReserve = false )
 	{
-		className.ToLower();
-
 		#ifdef EXPANSIONEXLOGPRINT
 		EXLogPrint("[ExpansionMarketTraderZone] RemoveStock | " + m_ZoneName + " | " + className + " | " + stock);
 		#endif
@@ -332,6 +520,8 @@ class ExpansionMarketTraderZone
 		if ( !GetExpansionSettings().GetMarket().GetItem( className, marketItem ) )
 			return;
 
+		className = marketItem.ClassName;
+
 		if ( Stock.Contains( className ) )
 		{
 			#ifdef EXPANSIONEXLOGPRINT
@@ -364,6 +554,8 @@ class ExpansionMarketTraderZone
 
 				Stock.Set( className, new_stock );
 
+				OnStockChanged( className );
+
 				#ifdef EXPANSIONEXLOGPRINT
 				EXLogPrint("[ExpansionMarketTraderZone] RemoveStock set " + className + " new_stock : " + new_stock);
 				#endif
@@ -377,27 +569,26 @@ class ExpansionMarketTraderZone
 
 			Stock.Insert( className, 0 );
 			ReservedStock.Insert( className, 0 );
+
+			OnStockChanged( className );
 		}
 	}
 
 	// ------------------------------------------------------------
 	// Expansion ItemExists
+	// Expects a lowercase class name
 	// ------------------------------------------------------------
 	bool ItemExists( string className )
 	{
-		className.ToLower();
-		
 		return Stock.Contains( className );
 	}
 
 	// ------------------------------------------------------------
 	// Expansion GetStock
-	// Gets the stock of an item within a trading zone
+	// Gets the stock of an item within a trading zone, expects a lowercase class name
 	// ------------------------------------------------------------
 	int GetStock( string className, bool actual = false )
 	{
-		className.ToLower();
-
 		if ( !ItemExists( className ) )
 			return -3; // -3 means the item does not exist in this trader zone
 
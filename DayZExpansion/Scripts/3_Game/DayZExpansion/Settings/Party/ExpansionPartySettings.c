@@ -20,6 +20,7 @@ class ExpansionPartySettings: ExpansionSettingBase
 	bool ShowPartyMembers3DMarkers;
 	bool UseWholeMapForInviteList; // Use it if you want whole map available in invite list, instead only nearby players
 	bool EnableQuickMarker;
+	bool SavePartiesAsBinary; // If enabled, parties are stored in the Groups.bin party database instead of one JSON file per party. Existing parties are converted on the next start.
 
 	[NonSerialized()]
 	private bool m_IsLoaded;
@@ -37,6 +38,13 @@ class ExpansionPartySettings: ExpansionSettingBase
 		EXPrint("ExpansionPartySettings::HandleRPC - Start");
 		#endif
 		
+		int hash;
+		if ( !ctx.Read( hash ) )
+		{
+			Error("ExpansionPartySettings::HandleRPC hash");
+			return;
+		}
+
 		ExpansionPartySettings setting;
 		if ( !ctx.Read( setting ) )
 		{
@@ -46,6 +54,9 @@ class ExpansionPartySettings: ExpansionSettingBase
 
 		CopyInternal( setting );
 
+		if ( OnReceive( hash ) )
+			ExpansionSettingSerializer< ExpansionPartySettings >.WriteCache( GetCacheFile(), hash, setting );
+
 		m_IsLoaded = true;
 
 		ExpansionSettings.SI_Party.Invoke();
@@ -69,6 +80,7 @@ class ExpansionPartySettings: ExpansionSettingBase
 		ref ExpansionPartySettings thisSetting = this;
 		
 		ScriptRPC rpc = new ScriptRPC;
+		rpc.Write( m_Hash );
 		rpc.Write( thisSetting );
 		rpc.Send( null, ExpansionSettingsRPC.Party, true, identity );
 		
@@ -81,6 +93,12 @@ class ExpansionPartySettings: ExpansionSettingBase
 	// ------------------------------------------------------------
 	// Expansion Send
 	// ------------------------------------------------------------
+	override void UpdateHash()
+	{
+		m_Hash = ExpansionSettingSerializer< ExpansionPartySettings >.Hash( this );
+	}
+
+	// ------------------------------------------------------------
     override bool Copy( ExpansionSettingBase setting )
     {
 		ExpansionPartySettings s;
@@ -98,6 +116,7 @@ class ExpansionPartySettings: ExpansionSettingBase
 		ShowPartyMembers3DMarkers = s.ShowPartyMembers3DMarkers;
 		UseWholeMapForInviteList = s.UseWholeMapForInviteList;
 		EnableQuickMarker = s.EnableQuickMarker;
+		SavePartiesAsBinary = s.SavePartiesAsBinary;
     }
 	
 	// ------------------------------------------------------------
@@ -167,5 +186,6 @@ class ExpansionPartySettings: ExpansionSettingBase
         ShowPartyMembers3DMarkers = true;
 		UseWholeMapForInviteList = false;
 		EnableQuickMarker = true;
+		SavePartiesAsBinary = false;
 	}
 }
\ No newline at end of file
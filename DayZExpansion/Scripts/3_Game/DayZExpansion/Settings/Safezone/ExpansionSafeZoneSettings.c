@@ -19,6 +19,11 @@ class ExpansionSafeZoneSettings: ExpansionSettingBase
 	bool EnableVehicleinvincibleInsideSafeZone;
 	//Frame rate check in ms.
 	int  FrameRateCheckSafeZoneInMs;
+	//Scheduled check, spreads the entity checks over several ticks. 0 checks every entity each FrameRateCheckSafeZoneInMs.
+	int  EntitiesCheckedPerTick;
+	int  ScheduledCheckSafeZoneInMs;
+	//Entities which moved less than this distance since their last scheduled check are skipped.
+	float MinMovementDistanceCheck;
 
 	autoptr array<ref ExpansionSafeZoneCircle> CircleZones;
 	autoptr array<ref ExpansionSafeZonePolygon> PolygonZones;
@@ -78,6 +83,9 @@ class ExpansionSafeZoneSettings: ExpansionSettingBase
 		Enabled = s.Enabled;
 		EnableVehicleinvincibleInsideSafeZone = s.EnableVehicleinvincibleInsideSafeZone;
 		FrameRateCheckSafeZoneInMs = s.FrameRateCheckSafeZoneInMs;
+		EntitiesCheckedPerTick = s.EntitiesCheckedPerTick;
+		ScheduledCheckSafeZoneInMs = s.ScheduledCheckSafeZoneInMs;
+		MinMovementDistanceCheck = s.MinMovementDistanceCheck;
     }
 	
 	// ------------------------------------------------------------
@@ -142,6 +150,9 @@ class ExpansionSafeZoneSettings: ExpansionSettingBase
 		Enabled = false;
 		EnableVehicleinvincibleInsideSafeZone = true;
 		FrameRateCheckSafeZoneInMs = 5000;
+		EntitiesCheckedPerTick = 100;
+		ScheduledCheckSafeZoneInMs = 100;
+		MinMovementDistanceCheck = 1.0;
 
 		//Example for adding a safezone with a polygon zone
 		TVectorArray points = new TVectorArray;
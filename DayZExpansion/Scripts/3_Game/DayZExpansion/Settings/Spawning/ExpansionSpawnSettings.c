@@ -39,6 +39,13 @@ class ExpansionSpawnSettings: ExpansionSettingBase
 		EXPrint("ExpansionSpawnSettings::HandleRPC - Start");
 		#endif
 		
+		int hash;
+		if ( !ctx.Read( hash ) )
+		{
+			Error("ExpansionSpawnSettings::HandleRPC hash");
+			return;
+		}
+
 		ExpansionSpawnSettings setting;
 		if ( !ctx.Read( setting ) )
 		{
@@ -48,6 +55,9 @@ class ExpansionSpawnSettings: ExpansionSettingBase
 
 		CopyInternal( setting );
 
+		if ( OnReceive( hash ) )
+			ExpansionSettingSerializer< ExpansionSpawnSettings >.WriteCache( GetCacheFile(), hash, setting );
+
 		m_IsLoaded = true;
 
 		ExpansionSettings.SI_Spawn.Invoke();
@@ -72,6 +82,7 @@ class ExpansionSpawnSettings: ExpansionSettingBase
 		ref ExpansionSpawnSettings thisSetting = this;
 		
 		ScriptRPC rpc = new ScriptRPC;
+		rpc.Write( m_Hash );
 		rpc.Write( thisSetting );
 		rpc.Send( null, ExpansionSettingsRPC.Spawn, true, identity );
 		
@@ -81,6 +92,12 @@ class ExpansionSpawnSettings: ExpansionSettingBase
 		return 0;
 	}
 
+	// ------------------------------------------------------------
+	override void UpdateHash()
+	{
+		m_Hash = ExpansionSettingSerializer< ExpansionSpawnSettings >.Hash( this );
+	}
+
 	// ------------------------------------------------------------
     override bool Copy( ExpansionSettingBase setting )
     {
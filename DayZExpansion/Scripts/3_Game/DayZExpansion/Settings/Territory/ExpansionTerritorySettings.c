@@ -42,6 +42,13 @@ class ExpansionTerritorySettings: ExpansionSettingBase
 		EXPrint("ExpansionTerritorySettings::HandleRPC - Start");
 		#endif
 		
+		int hash;
+		if ( !ctx.Read( hash ) )
+		{
+			Error("ExpansionTerritorySettings::HandleRPC hash");
+			return;
+		}
+
 		ExpansionTerritorySettings setting;
 		if ( !ctx.Read( setting ) )
 		{
@@ -50,6 +57,9 @@ class ExpansionTerritorySettings: ExpansionSettingBase
 		}
 
 		CopyInternal( setting );
+
+		if ( OnReceive( hash ) )
+			ExpansionSettingSerializer< ExpansionTerritorySettings >.WriteCache( GetCacheFile(), hash, setting );
 		
 		m_IsLoaded = true;
 
@@ -75,6 +85,7 @@ class ExpansionTerritorySettings: ExpansionSettingBase
 		ref ExpansionTerritorySettings thisSetting = this;
 		
 		ScriptRPC rpc = new ScriptRPC;
+		rpc.Write( m_Hash );
 		rpc.Write( thisSetting );
 		rpc.Send( null, ExpansionSettingsRPC.Territory, true, identity );
 		
@@ -84,6 +95,12 @@ class ExpansionTerritorySettings: ExpansionSettingBase
 		return 0;
 	}
 
+	// ------------------------------------------------------------
+	override void UpdateHash()
+	{
+		m_Hash = ExpansionSettingSerializer< ExpansionTerritorySettings >.Hash( this );
+	}
+
 	// ------------------------------------------------------------
     override bool Copy( ExpansionSettingBase setting )
     {
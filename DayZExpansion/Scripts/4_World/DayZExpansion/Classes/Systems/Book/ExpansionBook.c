@@ -180,6 +180,10 @@ class ExpansionBook extends UIScriptedMenu
 	{
 		super.OnHide();
 
+		//! Let the open tab know it is no longer visible, LastOpenedTab reopens it next time
+		if ( m_CurrentOpenTab )
+			m_CurrentOpenTab.HideLayout();
+
 		GetGame().GetMission().PlayerControlEnable(true);
 		
 		PPEffects.SetBlurInventory( 0.0 );
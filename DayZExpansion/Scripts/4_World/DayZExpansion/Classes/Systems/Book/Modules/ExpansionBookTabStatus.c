@@ -113,6 +113,11 @@ class ExpansionBookTabStatus extends ExpansionBookTabBase
 		
 		m_Time = 0;
 
+		if (!m_MonitorModule)
+			m_MonitorModule = ExpansionMonitorModule.Cast( GetModuleManager().GetModule( ExpansionMonitorModule ) );
+
+		m_MonitorModule.SubscribeStats( true );
+
 		UpdateValues();
 	}
 	
@@ -175,6 +180,9 @@ class ExpansionBookTabStatus extends ExpansionBookTabBase
 	override void OnHidedLayout()
 	{
 		m_Time = 0;
+
+		if ( m_MonitorModule )
+			m_MonitorModule.SubscribeStats( false );
 	}
 	
 	// ------------------------------------------------------------
@@ -30,28 +30,33 @@ enum ExpansionDamageSource
 	COUNT,
 }
 
-class ExpansionKillFeedData
+class ExpansionKillFeedHitRecord
 {
-	int m_DmgType;
-	EntityAI m_Source;
-	string m_Ammo;
-	
-	void ExpansionKillFeedData(int damageType, EntityAI source, string ammo)
+	int DamageSource;
+	EntityAI Source;
+	EntityAI SourceParent;
+	CarScript Vehicle;
+	EntityAI VehicleDriver;
+
+	//! Tick time of the hit
+	float Time;
+
+	void ExpansionKillFeedHitRecord()
 	{
-		m_DmgType = damageType;
-		m_Source = source;
-		m_Ammo = ammo;
+		DamageSource = ExpansionDamageSource.NONE;
 	}
 }
 	
 class ExpansionKillFeedModule: JMModuleBase
 {
-	protected EntityAI m_HitSource;
-	protected EntityAI m_HitSourceParent;
-	protected EntityAI m_VehicleDriver;
-	protected int m_LastDamageSource;
-	
-	protected CarScript m_Vehicle;
+	//! Seconds after which the last hit on a player isn't used for the kill message anymore
+	static const float HIT_RECORD_TIMEOUT = 3.0;
+
+	//! Last hit of every player, keyed by the network ID of the player
+	protected autoptr map< string, ref ExpansionKillFeedHitRecord > m_HitRecords;
+
+	//! Display names by class name
+	protected autoptr map< string, string > m_DisplayNames;
 	
 	protected string m_PlayerName;
 	protected PlayerBase m_KillerPlayer;
@@ -60,6 +65,7 @@ class ExpansionKillFeedModule: JMModuleBase
 	protected string m_KillerName;
 	protected ItemBase m_KillerWeapon;
 	protected ref StringLocaliser m_Killfeed;
+	protected ref StringLocaliser m_KillfeedTitle;
 	protected ItemBase m_PlayerItemInHands;
 	
 	// ------------------------------------------------------------
@@ -71,6 +77,11 @@ class ExpansionKillFeedModule: JMModuleBase
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("ExpansionKillFeedModule::ExpansionKillFeedModule - Start");
 		#endif
+
+		m_HitRecords = new map< string, ref ExpansionKillFeedHitRecord >;
+		m_DisplayNames = new map< string, string >;
+
+		m_KillfeedTitle = new StringLocaliser( "STR_EXPANSION_KILLFEED_TITLE" );
 		
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("ExpansionKillFeedModule::ExpansionKillFeedModule - End");
@@ -100,15 +111,129 @@ class ExpansionKillFeedModule: JMModuleBase
 		return m_Enabled && GetExpansionSettings().GetGeneral().EnableKillFeed;
 	}
 	
+	// ------------------------------------------------------------
+	// ExpansionKillFeedModule OnInvokeDisconnect
+	// ------------------------------------------------------------
+	override void OnInvokeDisconnect( PlayerBase player )
+	{
+		super.OnInvokeDisconnect( player );
+
+		if ( player )
+			RemoveHitRecord( player );
+	}
+	
+	// ------------------------------------------------------------
+	// ExpansionKillFeedModule OnMissionFinish
+	// ------------------------------------------------------------
+	override void OnMissionFinish()
+	{
+		super.OnMissionFinish();
+
+		m_HitRecords.Clear();
+	}
+	
+	// ------------------------------------------------------------
+	// ExpansionKillFeedModule GetHitRecordKey
+	// ------------------------------------------------------------
+	protected string GetHitRecordKey( PlayerBase player )
+	{
+		int low;
+		int high;
+		player.GetNetworkID( low, high );
+
+		return low.ToString() + ":" + high.ToString();
+	}
+	
+	// ------------------------------------------------------------
+	// ExpansionKillFeedModule RemoveHitRecord
+	// ------------------------------------------------------------
+	protected void RemoveHitRecord( PlayerBase player )
+	{
+		m_HitRecords.Remove( GetHitRecordKey( player ) );
+	}
+	
+	// ------------------------------------------------------------
+	// ExpansionKillFeedModule TakeHitRecord
+	// Removes and returns the last hit of the player, a record with no source when it's too old
+	// ------------------------------------------------------------
+	protected ExpansionKillFeedHitRecord TakeHitRecord( PlayerBase player )
+	{
+		string key = GetHitRecordKey( player );
+
+		ExpansionKillFeedHitRecord hit;
+		if ( m_HitRecords.Find( key, hit ) )
+		{
+			m_HitRecords.Remove( key );
+
+			if ( GetGame().GetTickTime() - hit.Time <= HIT_RECORD_TIMEOUT )
+				return hit;
+		}
+
+		return new ExpansionKillFeedHitRecord;
+	}
+	
+	// ------------------------------------------------------------
+	// ExpansionKillFeedModule GetDisplayName
+	// ------------------------------------------------------------
+	protected string GetDisplayName( EntityAI entity )
+	{
+		string type = entity.GetType();
+
+		string displayName;
+		if ( !m_DisplayNames.Find( type, displayName ) )
+		{
+			displayName = entity.GetDisplayName();
+			m_DisplayNames.Insert( type, displayName );
+		}
+
+		return displayName;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionKillFeedModule SendKillFeedNotification
+	// ------------------------------------------------------------
+	protected void SendKillFeedNotification()
+	{
+		ExpansionNotificationModule notificationModule;
+		if ( Class.CastTo( notificationModule, GetModuleManager().GetModule( ExpansionNotificationModule ) ) )
+			notificationModule.NotifyAll( m_KillfeedTitle, m_Killfeed, EXPANSION_NOTIFICATION_ICON_BANDIT, COLOR_EXPANSION_NOTIFICATION_EXPANSION, 7 );
+	}
+
 	// ------------------------------------------------------------
 	// ExpansionKillFeedModule OnPlayerHitEvent
+	// Remembers the hit as the last one of the player
 	// ------------------------------------------------------------
-	void OnPlayerHitEvent(int damageType, EntityAI source, string ammo)
+	void OnPlayerHitEvent( PlayerBase player, int damageType, EntityAI source, string ammo )
 	{
-		m_HitSource = NULL;
-		m_HitSourceParent = NULL;
-		m_LastDamageSource = ExpansionDamageSource.NONE;
-		Man driver;
+		if ( !player || !source )
+			return;
+
+		string key = GetHitRecordKey( player );
+
+		ExpansionKillFeedHitRecord hit;
+		if ( !m_HitRecords.Find( key, hit ) )
+		{
+			hit = new ExpansionKillFeedHitRecord;
+			m_HitRecords.Insert( key, hit );
+		}
+
+		ResolveHit( damageType, source, ammo, hit );
+	}
+	
+	// ------------------------------------------------------------
+	// ExpansionKillFeedModule ResolveHit
+	// ------------------------------------------------------------
+	protected void ResolveHit( int damageType, EntityAI source, string ammo, ExpansionKillFeedHitRecord hit )
+	{
+		hit.DamageSource = ExpansionDamageSource.NONE;
+		hit.Source = NULL;
+		hit.SourceParent = NULL;
+		hit.Vehicle = NULL;
+		hit.VehicleDriver = NULL;
+		hit.Time = GetGame().GetTickTime();
+
+		EntityAI parent = EntityAI.Cast( source.GetHierarchyParent() );
+
 		Man player;
 		
 		CarScript car;
@@ -119,48 +244,31 @@ class ExpansionKillFeedModule: JMModuleBase
 			case DT_CLOSE_COMBAT:
 			{
 				#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - DT_CLOSE_COMBAT");
-		#endif
+				EXLogPrint("ExpansionKillFeedModule::ResolveHit - DT_CLOSE_COMBAT");
+				#endif
 
 				if ( source.IsZombie() )
 				{
-					#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - INFECTED");
-		#endif
-
-					m_LastDamageSource = ExpansionDamageSource.INFECTED;
-					m_HitSource = source;
+					hit.DamageSource = ExpansionDamageSource.INFECTED;
+					hit.Source = source;
 				}			
 				else if ( source.IsAnimal() )
 				{
-					#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - ANIMAL");
-		#endif
-
-					m_LastDamageSource = ExpansionDamageSource.ANIMAL;
-					m_HitSource = source;
+					hit.DamageSource = ExpansionDamageSource.ANIMAL;
+					hit.Source = source;
 				}
 				else if ( source.IsPlayer() )
 				{
-					#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - FIST");
-		#endif	
-
-					m_LastDamageSource = ExpansionDamageSource.FIST;	
-					m_HitSource = source;	
+					hit.DamageSource = ExpansionDamageSource.FIST;	
+					hit.Source = source;	
 				}
 				else if ( source.IsMeleeWeapon() )
 				{
-					#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - MELEWEAPON");
-		#endif
-
-					m_LastDamageSource = ExpansionDamageSource.PLAYER_MELEWEAPON;
-					if ( source.GetHierarchyParent().IsInherited( SurvivorBase ) )
+					hit.DamageSource = ExpansionDamageSource.PLAYER_MELEWEAPON;
+					if ( parent && parent.IsInherited( SurvivorBase ) )
 					{
-						m_HitSource = source;
-						if ( source.GetHierarchyParent() != NULL )
-							m_HitSourceParent = EntityAI.Cast( source.GetHierarchyParent() );
+						hit.Source = source;
+						hit.SourceParent = parent;
 					}
 				}
 				break;
@@ -168,17 +276,16 @@ class ExpansionKillFeedModule: JMModuleBase
 			case DT_FIRE_ARM:
 			{
 				#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - DT_FIRE_ARM");
-		#endif
+				EXLogPrint("ExpansionKillFeedModule::ResolveHit - DT_FIRE_ARM");
+				#endif
 
 				if ( source.IsWeapon() )
 				{
-					m_LastDamageSource = ExpansionDamageSource.PLAYER_WEAPON;
-					if ( source.GetHierarchyParent().IsInherited( SurvivorBase ) )
+					hit.DamageSource = ExpansionDamageSource.PLAYER_WEAPON;
+					if ( parent && parent.IsInherited( SurvivorBase ) )
 					{
-						m_HitSource = source;
-						if ( source.GetHierarchyParent() != NULL )
-							m_HitSourceParent = EntityAI.Cast( source.GetHierarchyParent() );
+						hit.Source = source;
+						hit.SourceParent = parent;
 					}
 				}
 				break;
@@ -186,151 +293,89 @@ class ExpansionKillFeedModule: JMModuleBase
 			case DT_EXPLOSION:
 			{
 				#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - DT_EXPLOSION");
-		#endif
+				EXLogPrint("ExpansionKillFeedModule::ResolveHit - DT_EXPLOSION");
+				#endif
 
 				//! Explosion source was a weapon (Grenade/Launcher/Explosive)
 				if ( source.IsWeapon() || source.IsInherited( ItemBase ) || source.IsInherited( Ammunition_Base ) )
 				{
-					#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - Explosion came from weapon!");
-		#endif
-
-					m_LastDamageSource = ExpansionDamageSource.EXPLOSION_WEAPON;
-					m_HitSource = source;
-					if ( source.GetHierarchyParent() != NULL )
-						m_HitSourceParent = EntityAI.Cast( source.GetHierarchyParent() );
+					hit.DamageSource = ExpansionDamageSource.EXPLOSION_WEAPON;
+					hit.Source = source;
+					hit.SourceParent = parent;
 				}
 				//! Explosion source was a vehicle (Car/Heli)
-				else if ( source.GetHierarchyParent().IsInherited( CarScript ) || source.GetHierarchyParent().IsInherited( ExpansionHelicopterScript ) )
+				else if ( parent && ( parent.IsInherited( CarScript ) || parent.IsInherited( ExpansionHelicopterScript ) ) )
 				{
-					#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - Explosion came from vehicle!");
-		#endif
-
-					m_LastDamageSource = ExpansionDamageSource.EXPLOSION_VEHICLE;
-					m_HitSource = source.GetHierarchyParent();
+					hit.DamageSource = ExpansionDamageSource.EXPLOSION_VEHICLE;
+					hit.Source = parent;
 				}
 				break;
 			}					
 			case DT_CUSTOM:
 			{
 				#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - DT_CUSTOM");
-		#endif
+				EXLogPrint("ExpansionKillFeedModule::ResolveHit - DT_CUSTOM " + ammo);
+				#endif
+
 				if ( ammo == "FallDamage" )
 				{
-					m_LastDamageSource = ExpansionDamageSource.FALLING;
-
-					#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - FALLING");
-		#endif
+					hit.DamageSource = ExpansionDamageSource.FALLING;
 				}
 				//! Player got rolled over/hit by a vehicle
 				else if ( source.GetType() == "AreaDamageBase" )  
 				{
 					// Check if hit came from a car
-					if ( source.GetHierarchyParent().IsKindOf( "CarScript" ) )
+					if ( parent && parent.IsKindOf( "CarScript" ) )
 					{
-						#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - VEHICLE HIT");
-		#endif
-
-						m_LastDamageSource = ExpansionDamageSource.VEHICLE_HIT;
-						m_HitSource = source;
+						hit.DamageSource = ExpansionDamageSource.VEHICLE_HIT;
+						hit.Source = source;
 						car = CarScript.Cast( source );
-						if ( car.CrewSize() > 0 )
+						if ( car && car.CrewSize() > 0 )
 						{
 							player = car.CrewMember( 0 );
 							if ( player )
-								m_HitSourceParent = player;
+								hit.SourceParent = player;
 						}
 					}
 					// Check if hit came from a helicopter
-					else if ( source.GetHierarchyParent().IsKindOf( "HelicopterScript" ) )
+					else if ( parent && parent.IsKindOf( "HelicopterScript" ) )
 					{
-						#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - HELICOPTER HIT");
-		#endif
-
-						m_LastDamageSource = ExpansionDamageSource.HELICOPTER_HIT;
-						m_HitSource = source;
+						hit.DamageSource = ExpansionDamageSource.HELICOPTER_HIT;
+						hit.Source = source;
 						heli = HelicopterScript.Cast( source );
-						if ( heli.CrewSize() > 0 )
+						if ( heli && heli.CrewSize() > 0 )
 						{
 							player = heli.CrewMember( 0 );
 							if ( player )
-								m_HitSourceParent = player;
+								hit.SourceParent = player;
 						}
 					}
 				}
 				//! Player crashed with his vehicle
 				else if ( ammo == "TransportHit" )
 				{
-					#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - TRANSPORT HIT");
-		#endif
+					hit.DamageSource = ExpansionDamageSource.VEHICLE_CRASH;
+					hit.Source = source;
 					
-					#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint( "ExpansionKillFeedModule:: Source: " + source.GetType() );
-		#endif
-
-					m_LastDamageSource = ExpansionDamageSource.VEHICLE_CRASH;
-					m_HitSource = source;
-					
-					if ( source.IsKindOf( "CarScript" ) )
+					if ( Class.CastTo( car, source ) )
 					{
-						car = CarScript.Cast( source );
-						m_Vehicle = car;
-						if ( car.IsCar() )
+						hit.Vehicle = car;
+						if ( ( car.IsCar() || car.IsHelicopter() ) && car.CrewSize() > 0 )
 						{
-							#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint( "ExpansionKillFeedModule::OnPlayerHitEvent - Vehicle was a car!" );
-		#endif
-														
-							if ( car.CrewSize() > 0 )
-							{
-								driver = car.CrewMember( 0 );
-								if ( driver )
-									m_VehicleDriver = driver;
-							}
-						}
-						else if ( car.IsHelicopter() )
-						{
-							#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint( "ExpansionKillFeedModule::OnPlayerHitEvent - Vehicle was a helicopter!" );
-		#endif		
-
-							if ( car.CrewSize() > 0 )
-							{
-								driver = car.CrewMember( 0 );
-								if ( driver )
-									m_VehicleDriver = driver;
-							}
+							hit.VehicleDriver = car.CrewMember( 0 );
 						}
 					}
 				}
 				else if ( ammo == "FireDamage" )
 				{
-					#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionKillFeedModule::OnPlayerHitEvent - FIRE HIT");
-		#endif
-
-					m_LastDamageSource = ExpansionDamageSource.FIRE;
-					m_HitSource = source;
+					hit.DamageSource = ExpansionDamageSource.FIRE;
+					hit.Source = source;
 				}
 				break;
 			}
-			
-			GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).CallLater( this.ResetLastHitSource, 3000, false );
 		}
 	}
 	
-	void ResetLastHitSource()
-	{
-		m_LastDamageSource = ExpansionDamageSource.NONE;
-	}
-	
 	// ------------------------------------------------------------
 	// ExpansionKillFeedModule OnPlayerKilledEventNew
 	// ------------------------------------------------------------
@@ -348,13 +393,14 @@ class ExpansionKillFeedModule: JMModuleBase
 		m_Killfeed 				= NULL;
 		m_PlayerItemInHands 	= NULL;
 		
-		#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint( "ExpansionKillFeedModule::OnPlayerKilledEventNew - killer: " + killer.ClassName() );
-		#endif
-		
 		if ( !player )
 			return;
 
+		#ifdef EXPANSIONEXLOGPRINT
+		if ( killer )
+			EXLogPrint( "ExpansionKillFeedModule::OnPlayerKilledEventNew - killer: " + killer.ClassName() );
+		#endif
+
 		m_PlayerName = player.GetIdentityName();
 		
 		float statWater = player.GetStatWater().Get();
@@ -410,44 +456,44 @@ class ExpansionKillFeedModule: JMModuleBase
 					}
 					else if ( GetExpansionSettings() && GetExpansionSettings().GetGeneral().KillFeedMessageType == ExpansionAnnouncementType.NOTIFICATION )
 					{
-						GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_KILLFEED_TITLE" ), m_Killfeed, EXPANSION_NOTIFICATION_ICON_BANDIT, COLOR_EXPANSION_NOTIFICATION_EXPANSION, 7 );
+						SendKillFeedNotification();
 						GetExpansionLogger().KillFeedLog( m_Killfeed.Format() );
 					}
 				}
+
+				RemoveHitRecord( player );
+
+				if ( dehydration )
+					LogKillEvent( player, "DEHYDRATION", NULL );
+				else if ( starvation )
+					LogKillEvent( player, "STARVATION", NULL );
+				else
+					LogKillEvent( player, "BLEEDING", NULL );
 				
 				return;
 			}
 		}
 		
-		ref ExpansionKillFeedData hitData = player.GetCurrentHitData();
-		if ( hitData && hitData != null )
-		{
-			OnPlayerHitEvent( hitData.m_DmgType, hitData.m_Source, hitData.m_Ammo );
-		}
-		else if ( !hitData )
-		{
-			m_LastDamageSource = ExpansionDamageSource.NONE;
-		}
+		ref ExpansionKillFeedHitRecord hit = TakeHitRecord( player );
 		
-		switch ( m_LastDamageSource )
+		switch ( hit.DamageSource )
 		{
 			case ExpansionDamageSource.EXPLOSION_WEAPON:
 			{
-				if ( m_HitSource /*&& ( m_HitSource.IsInherited( Grenade_Base ) || m_HitSource.IsInherited( Ammunition_Base ) )*/)
+				if ( hit.Source /*&& ( hit.Source.IsInherited( Grenade_Base ) || hit.Source.IsInherited( Ammunition_Base ) )*/)
 				{
-					if ( m_HitSourceParent != NULL )
+					if ( hit.SourceParent != NULL )
 					{
-						if ( m_HitSourceParent.IsInherited(SurvivorBase) )
+						if ( Class.CastTo( m_KillerPlayer, hit.SourceParent ) )
 						{
-							m_KillerPlayer = PlayerBase.Cast( m_HitSourceParent );
 							m_KillerName = m_KillerPlayer.GetIdentityName();
-							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_DIED_EXPLOSION_WEAPON", m_PlayerName, m_HitSource.GetDisplayName(), m_KillerName );
+							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_DIED_EXPLOSION_WEAPON", m_PlayerName, GetDisplayName( hit.Source ), m_KillerName );
 							msg = true;
 						}
 					}
 					else
 					{
-						m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_DIED_EXPLOSION", m_PlayerName, m_HitSource.GetDisplayName() );
+						m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_DIED_EXPLOSION", m_PlayerName, GetDisplayName( hit.Source ) );
 						msg = true;
 					}
 				}
@@ -456,9 +502,9 @@ class ExpansionKillFeedModule: JMModuleBase
 			//! Todo: Does not work yet
 			case ExpansionDamageSource.EXPLOSION_VEHICLE:
 			{
-				if ( m_HitSource )
+				if ( hit.Source )
 				{
-					m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_DIED_EXPLOSION_VEHICLE", m_PlayerName, m_HitSource.GetDisplayName() );
+					m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_DIED_EXPLOSION_VEHICLE", m_PlayerName, GetDisplayName( hit.Source ) );
 					msg = true;
 				}
 				break;
@@ -475,17 +521,17 @@ class ExpansionKillFeedModule: JMModuleBase
 			}
 			case ExpansionDamageSource.PLAYER_WEAPON:
 			{
-				if ( m_HitSource && m_HitSource.IsWeapon() )
+				if ( hit.Source && hit.Source.IsWeapon() )
 				{
-					if ( m_HitSourceParent != NULL )
+					if ( hit.SourceParent != NULL )
 					{
-						if ( m_HitSourceParent.IsInherited(SurvivorBase) )
+						if ( Class.CastTo( m_KillerPlayer, hit.SourceParent ) )
 						{
-							m_KillerPlayer = PlayerBase.Cast( m_HitSourceParent );
 							m_KillerName = m_KillerPlayer.GetIdentityName();
-							m_KillerWeapon = m_KillerPlayer.GetItemInHands();
-							float shootDistance = vector.Distance( player.GetPosition(), m_KillerWeapon.GetPosition() );
-							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_PLAYER_WEAPON", m_PlayerName, m_KillerName, m_KillerWeapon.GetDisplayName(), Math.Round(shootDistance).ToString() );
+							//! The weapon that fired, the killer may have holstered or dropped it since
+							m_KillerWeapon = ItemBase.Cast( hit.Source );
+							float shootDistance = vector.Distance( player.GetPosition(), hit.Source.GetPosition() );
+							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_PLAYER_WEAPON", m_PlayerName, m_KillerName, GetDisplayName( hit.Source ), Math.Round(shootDistance).ToString() );
 							msg = true;
 						}
 					}
@@ -494,16 +540,15 @@ class ExpansionKillFeedModule: JMModuleBase
 			}
 			case ExpansionDamageSource.PLAYER_MELEWEAPON:
 			{
-				if ( m_HitSource && m_HitSource.IsWeapon())
+				if ( hit.Source && hit.Source.IsWeapon())
 				{
-					if ( m_HitSourceParent != NULL )
+					if ( hit.SourceParent != NULL )
 					{
-						if ( m_HitSourceParent.IsInherited(SurvivorBase) )
+						if ( Class.CastTo( m_KillerPlayer, hit.SourceParent ) )
 						{
-							m_KillerPlayer = PlayerBase.Cast( m_HitSourceParent );
 							m_KillerName = m_KillerPlayer.GetIdentityName();
-							m_KillerWeapon = m_KillerPlayer.GetItemInHands();
-							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_PLAYER_MELE", m_PlayerName, m_KillerName, m_KillerWeapon.GetDisplayName() );
+							m_KillerWeapon = ItemBase.Cast( hit.Source );
+							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_PLAYER_MELE", m_PlayerName, m_KillerName, GetDisplayName( hit.Source ) );
 							msg = true;
 						}
 					}
@@ -512,7 +557,7 @@ class ExpansionKillFeedModule: JMModuleBase
 			}
 			case ExpansionDamageSource.INFECTED:
 			{
-				if ( m_HitSource && m_HitSource.IsZombie() )
+				if ( hit.Source && hit.Source.IsZombie() )
 				{
 					m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_ZOMBIE", m_PlayerName );
 					msg = true;
@@ -521,24 +566,23 @@ class ExpansionKillFeedModule: JMModuleBase
 			}
 			case ExpansionDamageSource.ANIMAL:
 			{
-				if ( m_HitSource && m_HitSource.IsAnimal() )
+				if ( hit.Source && hit.Source.IsAnimal() )
 				{
-					m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_ANIMAL", m_PlayerName, m_HitSource.GetDisplayName() );
+					m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_ANIMAL", m_PlayerName, GetDisplayName( hit.Source ) );
 					msg = true;
 				}
 				break;
 			}
 			case ExpansionDamageSource.VEHICLE_HIT:
 			{
-				if ( m_HitSource && ( m_HitSource.IsInherited( CarScript ) ) )
+				if ( hit.Source && ( hit.Source.IsInherited( CarScript ) ) )
 				{
-					if ( m_HitSourceParent != NULL )
+					if ( hit.SourceParent != NULL )
 					{
-						if ( m_HitSourceParent.IsInherited( SurvivorBase ) )
+						if ( Class.CastTo( m_KillerPlayer, hit.SourceParent ) )
 						{
-							m_KillerPlayer = PlayerBase.Cast( m_HitSourceParent );
 							m_KillerName = m_KillerPlayer.GetIdentityName();
-							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_DIED_VEHICLE", m_PlayerName, m_KillerName, m_HitSource.GetDisplayName() );
+							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_DIED_VEHICLE", m_PlayerName, m_KillerName, GetDisplayName( hit.Source ) );
 							msg = true;
 						}
 					}
@@ -547,15 +591,14 @@ class ExpansionKillFeedModule: JMModuleBase
 			}
 			case ExpansionDamageSource.HELICOPTER_HIT:
 			{
-				if ( m_HitSource && ( m_HitSource.IsKindOf( "HelicopterScript" ) ) )
+				if ( hit.Source && ( hit.Source.IsKindOf( "HelicopterScript" ) ) )
 				{
-					if ( m_HitSourceParent != NULL )
+					if ( hit.SourceParent != NULL )
 					{
-						if ( m_HitSourceParent.IsInherited( SurvivorBase ) )
+						if ( Class.CastTo( m_KillerPlayer, hit.SourceParent ) )
 						{
-							m_KillerPlayer = PlayerBase.Cast( m_HitSourceParent );
 							m_KillerName = m_KillerPlayer.GetIdentityName();
-							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_DIED_VEHICLE", m_PlayerName, m_KillerName, m_HitSource.GetDisplayName() );
+							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_DIED_VEHICLE", m_PlayerName, m_KillerName, GetDisplayName( hit.Source ) );
 							msg = true;
 						}
 					}
@@ -564,53 +607,55 @@ class ExpansionKillFeedModule: JMModuleBase
 			}
 			case ExpansionDamageSource.VEHICLE_CRASH:
 			{
-				if ( m_HitSource )
+				if ( hit.Source && hit.Vehicle )
 				{
 					//! Vehicle had active driver as it crashed
-					if ( m_VehicleDriver )
+					if ( hit.VehicleDriver )
 					{						
 						//! Vehicle was a helicopter
-						if ( m_Vehicle.IsHelicopter() )
+						if ( hit.Vehicle.IsHelicopter() )
 						{
 							//! Get heli driver as he as the one who crashed the vehicle
-							m_KillerPlayer = PlayerBase.Cast( m_VehicleDriver );
-							m_KillerName = m_KillerPlayer.GetIdentityName();
+							m_KillerPlayer = PlayerBase.Cast( hit.VehicleDriver );
 
 							if ( m_KillerPlayer )
 							{
+								m_KillerName = m_KillerPlayer.GetIdentityName();
+
 								//! If the killed player is not the driver of heli, he was killed by driver
 								if ( m_KillerPlayer != player )
 								{
-									m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_CRASH_HELI", m_PlayerName, m_HitSource.GetDisplayName(), m_KillerName );
+									m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_CRASH_HELI", m_PlayerName, GetDisplayName( hit.Source ), m_KillerName );
 									msg = true;
 								}
 								//! Killed player was the heli driver
 								else
 								{
-									m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_CRASHED_HELI", m_PlayerName, m_HitSource.GetDisplayName() );
+									m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_CRASHED_HELI", m_PlayerName, GetDisplayName( hit.Source ) );
 									msg = true;
 								}
 							}
 						}
 						//! Vehicle was a car
-						else if ( m_Vehicle.IsCar() )
+						else if ( hit.Vehicle.IsCar() )
 						{
 							//! Get vehicle driver as he as the one who crashed the vehicle
-							m_KillerPlayer = PlayerBase.Cast( m_VehicleDriver );
-							m_KillerName = m_KillerPlayer.GetIdentityName();
+							m_KillerPlayer = PlayerBase.Cast( hit.VehicleDriver );
 
 							if ( m_KillerPlayer )
 							{
+								m_KillerName = m_KillerPlayer.GetIdentityName();
+
 								//! If the killed player is not the driver he was killed by driver
 								if ( m_KillerPlayer != player )
 								{
-									m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_CRASH_CAR", m_PlayerName, m_HitSource.GetDisplayName(), m_KillerName );
+									m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_CRASH_CAR", m_PlayerName, GetDisplayName( hit.Source ), m_KillerName );
 									msg = true;
 								}
 								//! Killed player was the driver
 								else
 								{
-									m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_CRASHED_CAR", m_PlayerName, m_HitSource.GetDisplayName() );
+									m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_CRASHED_CAR", m_PlayerName, GetDisplayName( hit.Source ) );
 									msg = true;
 								}
 							}
@@ -620,15 +665,15 @@ class ExpansionKillFeedModule: JMModuleBase
 					else
 					{
 						//! Vehicle was a helicopter
-						if ( m_Vehicle.IsHelicopter() )
+						if ( hit.Vehicle.IsHelicopter() )
 						{
-							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_CRASH_HELI_NODRIVER", m_PlayerName, m_HitSource.GetDisplayName() );
+							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_CRASH_HELI_NODRIVER", m_PlayerName, GetDisplayName( hit.Source ) );
 							msg = true;
 						}
 						//! Vehicle was a car
-						else if ( m_Vehicle.IsCar() )
+						else if ( hit.Vehicle.IsCar() )
 						{
-							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_CRASH_CAR_NODRIVER", m_PlayerName, m_HitSource.GetDisplayName() );
+							m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_CRASH_CAR_NODRIVER", m_PlayerName, GetDisplayName( hit.Source ) );
 							msg = true;
 						}
 					}
@@ -643,7 +688,7 @@ class ExpansionKillFeedModule: JMModuleBase
 			}
 			case ExpansionDamageSource.FIRE:
 			{
-				if ( m_HitSource && m_HitSource.IsFireplace() )
+				if ( hit.Source && hit.Source.IsFireplace() )
 				{
 					m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_DIED_FIRE", m_PlayerName );
 					msg = true;
@@ -652,11 +697,10 @@ class ExpansionKillFeedModule: JMModuleBase
 			}
 			case ExpansionDamageSource.FIST:
 			{
-				if ( m_HitSource )
+				if ( hit.Source )
 				{
-					if ( m_HitSource.IsPlayer() )
+					if ( Class.CastTo( m_KillerPlayer, hit.Source ) )
 					{
-						m_KillerPlayer = PlayerBase.Cast( m_HitSource );
 						m_KillerName = m_KillerPlayer.GetIdentityName();
 						m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_KILLED_PLAYE_BAREHANDS", m_PlayerName, m_KillerName );
 						msg = true;
@@ -692,7 +736,7 @@ class ExpansionKillFeedModule: JMModuleBase
 								m_PlayerItemInHands = player.GetItemInHands();
 								if ( m_PlayerItemInHands )
 								{
-									m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_DIED_SUICIDE", m_PlayerName, m_PlayerItemInHands.GetDisplayName() );
+									m_Killfeed = new StringLocaliser( "STR_EXPANSION_KILLFEED_PLAYER_DIED_SUICIDE", m_PlayerName, GetDisplayName( m_PlayerItemInHands ) );
 									msg = true;
 								}
 							}
@@ -712,9 +756,37 @@ class ExpansionKillFeedModule: JMModuleBase
 			}
 			else if ( GetExpansionSettings() && GetExpansionSettings().GetGeneral().KillFeedMessageType == ExpansionAnnouncementType.NOTIFICATION )
 			{
-				GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_KILLFEED_TITLE" ), m_Killfeed, EXPANSION_NOTIFICATION_ICON_BANDIT, COLOR_EXPANSION_NOTIFICATION_EXPANSION, 7 );
+				SendKillFeedNotification();
 				GetExpansionLogger().KillFeedLog( m_Killfeed.Format() );
 			}
 		}
+
+		LogKillEvent( player, typename.EnumToString( ExpansionDamageSource, hit.DamageSource ), hit );
 	}
-}
\ No newline at end of file
+	
+	// ------------------------------------------------------------
+	// ExpansionKillFeedModule LogKillEvent
+	// Adds the outcome of the kill to the event stream
+	// ------------------------------------------------------------
+	protected void LogKillEvent( PlayerBase player, string cause, ExpansionKillFeedHitRecord hit )
+	{
+		string killerUID;
+		string weapon;
+		float distance;
+
+		if ( m_KillerPlayer && m_KillerPlayer != player )
+		{
+			killerUID = m_KillerPlayer.GetIdentityUID();
+			distance = vector.Distance( player.GetPosition(), m_KillerPlayer.GetPosition() );
+		}
+
+		if ( m_KillerWeapon )
+			weapon = m_KillerWeapon.GetType();
+		else if ( m_PlayerItemInHands )
+			weapon = m_PlayerItemInHands.GetType();
+		else if ( hit && hit.Source )
+			weapon = hit.Source.GetType();
+
+		GetExpansionLogger().Event( new ExpansionKillEventRecord( player.GetIdentityUID(), cause, killerUID, weapon, distance ) );
+	}
+}
@@ -12,6 +12,9 @@
 
 class Expansion3DMarker extends UIScriptedMenu
 {
+    //! Height above the entity used instead of the bone position for far away markers
+    static const float          BONE_FALLBACK_HEIGHT = 1.6;
+
     protected float             m_OriginalHeight;
     protected float             m_OriginalWidth;
 
@@ -35,7 +38,18 @@ class Expansion3DMarker extends UIScriptedMenu
     private int                 m_GreenColor;
     private int                 m_BlueColor;
 
-    void Expansion3DMarker( string name, string iconpath, int color, vector position, Object linkedObject = NULL, vector offset = "0 0 0", int bone = -1 )
+    //! Last values pushed to the widgets, they are only touched again when these change
+    protected string            m_Name;
+    protected string            m_IconPath;
+    protected int               m_Color;
+    protected int               m_CurrentAlpha;
+    protected int               m_CurrentDistance;
+    protected bool              m_IsShown;
+
+    //! Frame of the last screen update, used by Expansion3DMarkerModule to spread updates
+    protected int               m_LastUpdateFrame;
+
+    void Expansion3DMarker( string name = "", string iconpath = "", int color = 0, vector position = "0 0 0", Object linkedObject = NULL, vector offset = "0 0 0", int bone = -1 )
     {
        	layoutRoot = GetGame().GetWorkspace().CreateWidgets( "DayZExpansion/GUI/layouts/expansion_dynamic_marker.layout" );
 		if ( layoutRoot )
@@ -45,41 +59,17 @@ class Expansion3DMarker extends UIScriptedMenu
 	        m_MarkerDistanceText                = TextWidget.Cast( layoutRoot.FindAnyWidget( "MarkerDistance" ) );
 	        m_MarkerFrame                       = layoutRoot.FindAnyWidget( "MarkerFrame" );
 	
-	        if ( linkedObject != NULL )
-	        {
-	            m_LinkedObject = linkedObject;
-	        }
-	        else
-	        {
-	            m_MarkerPosition = Vector( position[0], GetGame().SurfaceY( position[0], position[2] ), position[2] );
-	        }
-	        
-	        m_UsingLinkedObject = ( linkedObject != NULL );
-	
-	        m_OffsetPosition = offset;
-	        m_BoneIndex = bone;
-	
 	        m_MarkerFrame.GetSize( m_OriginalWidth, m_OriginalHeight );
-	
-	        m_MarkerText.SetText( name );
 
-            int alpha;
-            int red;
-            int green;
-            int blue;
-            GetARGB(color, alpha, red, green, blue);
-           
-            m_AlphaColor = Math.Max(m_MinAlphaColor, alpha);
-            m_RedColor = red;
-            m_GreenColor = green;
-            m_BlueColor = blue;
+            m_IsShown = layoutRoot.IsVisible();
 
-            m_MarkerText.SetColor( ARGB(alpha, 255, 255, 255) );
-            m_MarkerDistanceText.SetColor( ARGB(alpha, 255, 255, 255) );
+            m_MarkerText.SetText( "" );
+            m_AlphaColor = m_MinAlphaColor;
+            m_CurrentAlpha = -1;
+            m_CurrentDistance = -1;
+            m_LastUpdateFrame = -1;
 
-	        m_MarkerIcon.LoadImageFile( 0, iconpath );
-	        m_MarkerIcon.SetImage( 0 );
-	        m_MarkerIcon.SetColor( color );
+            Set( name, iconpath, color, position, linkedObject, offset, bone );
 		}
     }
 
@@ -109,6 +99,74 @@ class Expansion3DMarker extends UIScriptedMenu
 		return false;
 	}
 
+    // ------------------------------------------------------------
+    // Expansion3DMarker Set
+    // Points the marker at new values, widgets are only touched for what changed
+    // ------------------------------------------------------------
+    void Set( string name, string iconpath, int color, vector position, Object linkedObject = NULL, vector offset = "0 0 0", int bone = -1 )
+    {
+        if ( !layoutRoot )
+            return;
+
+        m_LinkedObject = linkedObject;
+        m_UsingLinkedObject = ( linkedObject != NULL );
+
+        if ( !m_UsingLinkedObject && ( position[0] != m_MarkerPosition[0] || position[2] != m_MarkerPosition[2] ) )
+            m_MarkerPosition = Vector( position[0], GetGame().SurfaceY( position[0], position[2] ), position[2] );
+
+        m_OffsetPosition = offset;
+        m_BoneIndex = bone;
+
+        if ( name != m_Name )
+        {
+            m_Name = name;
+            m_MarkerText.SetText( name );
+        }
+
+        if ( iconpath != m_IconPath )
+        {
+            m_IconPath = iconpath;
+            m_MarkerIcon.LoadImageFile( 0, iconpath );
+            m_MarkerIcon.SetImage( 0 );
+        }
+
+        if ( color != m_Color )
+        {
+            m_Color = color;
+
+            int alpha;
+            GetARGB( color, alpha, m_RedColor, m_GreenColor, m_BlueColor );
+            m_AlphaColor = Math.Max( m_MinAlphaColor, alpha );
+
+            //! Forces the colours to be applied on the next update
+            m_CurrentAlpha = -1;
+        }
+    }
+
+    // ------------------------------------------------------------
+    // Expansion3DMarker Hide
+    // ------------------------------------------------------------
+    void Hide()
+    {
+        if ( m_IsShown && layoutRoot )
+        {
+            layoutRoot.Show( false );
+            m_IsShown = false;
+        }
+    }
+
+    // ------------------------------------------------------------
+    // Expansion3DMarker Release
+    // Called when the marker goes back to the pool
+    // ------------------------------------------------------------
+    void Release()
+    {
+        Hide();
+
+        m_LinkedObject = NULL;
+        m_UsingLinkedObject = false;
+    }
+
     override void Update( float timeslice )
 	{
         UpdateUI();
@@ -116,40 +174,67 @@ class Expansion3DMarker extends UIScriptedMenu
 
     void UpdateUI()
     {
-		if (!layoutRoot)
-		{
-			Close();
-            return;
-		}
-		
-        if ( m_UsingLinkedObject && m_LinkedObject == NULL )
-        {
+		Hud inGameHUD = GetGame().GetMission().GetHud();
+		Expansion3DMarkerModule module = Expansion3DMarkerModule.Cast( GetModuleManager().GetModule( Expansion3DMarkerModule ) );
+
+		bool visible = ( !inGameHUD || inGameHUD.GetHudState() ) && module && module.GetShowMarkers();
+
+        if ( !UpdateMarker( visible, GetGame().GetCurrentCameraPosition() ) )
             Close();
-            return;
+    }
+
+    // ------------------------------------------------------------
+    // Expansion3DMarker UpdateMarker
+    // Returns false once the linked object is gone and the marker can be released
+    // ------------------------------------------------------------
+    bool UpdateMarker( bool visible, vector cameraPosition )
+    {
+		if ( !layoutRoot || HasLostLinkedObject() )
+        {
+            Hide();
+            return false;
         }
 		
-		Hud inGameHUD = GetGame().GetMission().GetHud();
-        if ( inGameHUD && !inGameHUD.GetHudState() )
+        if ( !visible )
         {
-            layoutRoot.Show( false );
-            return;
+            Hide();
+            return true;
         }
-		
-		Expansion3DMarkerModule module;
-		if ( !Class.CastTo( module, GetModuleManager().GetModule( Expansion3DMarkerModule ) ) || !module.GetShowMarkers() )
-		{
-			layoutRoot.Show( false );
-            return;
-		}
 
+        UpdateScreen( GetWorldPosition( true ), cameraPosition );
+        return true;
+    }
+
+    // ------------------------------------------------------------
+    // Expansion3DMarker HasLostLinkedObject
+    // ------------------------------------------------------------
+    bool HasLostLinkedObject()
+    {
+        return m_UsingLinkedObject && m_LinkedObject == NULL;
+    }
+
+    // ------------------------------------------------------------
+    // Expansion3DMarker GetWorldPosition
+    // Bone lookups are only done when useBone is set, otherwise a fixed height above the entity is used
+    // ------------------------------------------------------------
+    vector GetWorldPosition( bool useBone )
+    {
         vector worldPosition;
 
         if ( m_UsingLinkedObject )
         {
-            Human manOB = Human.Cast( m_LinkedObject );
-            if ( m_BoneIndex != -1 && manOB )
+            Human manOB;
+            if ( m_BoneIndex != -1 && Class.CastTo( manOB, m_LinkedObject ) )
             {
-                worldPosition = manOB.GetBonePositionWS( m_BoneIndex );
+                if ( useBone )
+                {
+                    worldPosition = manOB.GetBonePositionWS( m_BoneIndex );
+                }
+                else
+                {
+                    worldPosition = m_LinkedObject.GetPosition();
+                    worldPosition[1] = worldPosition[1] + BONE_FALLBACK_HEIGHT;
+                }
             }
             else
             {
@@ -160,43 +245,69 @@ class Expansion3DMarker extends UIScriptedMenu
         {
             worldPosition = m_MarkerPosition;
         }
+
         //Add offset to the vector, example: player
-        worldPosition += m_OffsetPosition;
+        return worldPosition + m_OffsetPosition;
+    }
+
+    // ------------------------------------------------------------
+    // Expansion3DMarker GetLastUpdateFrame
+    // ------------------------------------------------------------
+    int GetLastUpdateFrame()
+    {
+        return m_LastUpdateFrame;
+    }
+
+    // ------------------------------------------------------------
+    // Expansion3DMarker UpdateScreen
+    // Projects the marker on the screen, widgets are only touched when their value changed
+    // ------------------------------------------------------------
+    void UpdateScreen( vector worldPosition, vector cameraPosition, int frame = -1 )
+    {
+        m_LastUpdateFrame = frame;
 
         vector posRelative = GetGame().GetScreenPosRelative( worldPosition );
 
         if ( posRelative[0] >= 1 || posRelative[0] <= 0 || posRelative[1] >= 1 || posRelative[1] <= 0 || posRelative[2] <= 0 )
         {
-			if (layoutRoot)
-			{
-           		layoutRoot.Show( false );
-           		return;
-			}
+            Hide();
+            return;
         }
 
         //Detect if we are pointing at it, if so reduce the alpha accordingly
         float dist = vector.Distance(posRelative, Vector(0.5, 0.5, posRelative[2]));
-        float alpha = LinearConversion( 0, 0.15, dist, m_MinAlphaColor, m_AlphaColor );
+        int alpha = LinearConversion( 0, 0.15, dist, m_MinAlphaColor, m_AlphaColor );
 
-        m_MarkerText.SetColor( ARGB(alpha, 255, 255, 255) );
-        m_MarkerDistanceText.SetColor( ARGB(alpha, 255, 255, 255) );
-        m_MarkerIcon.SetColor( ARGB(alpha, m_RedColor, m_GreenColor, m_BlueColor) );
+        if ( alpha != m_CurrentAlpha )
+        {
+            m_CurrentAlpha = alpha;
 
-        if ( layoutRoot && !layoutRoot.IsVisible() )
+            m_MarkerText.SetColor( ARGB(alpha, 255, 255, 255) );
+            m_MarkerDistanceText.SetColor( ARGB(alpha, 255, 255, 255) );
+            m_MarkerIcon.SetColor( ARGB(alpha, m_RedColor, m_GreenColor, m_BlueColor) );
+        }
+
+        if ( !m_IsShown )
+        {
             layoutRoot.Show( true );
+            m_IsShown = true;
+        }
 
         //Set text here with the distance
-        float distance = vector.Distance( GetGame().GetCurrentCameraPosition(), worldPosition );
-        m_MarkerDistanceText.SetText( Math.Ceil( distance ).ToString() + "m" );
-
-        //scale widget from the distance of player
-        if ( m_MarkerFrame )
+        int distance = Math.Ceil( vector.Distance( cameraPosition, worldPosition ) );
+        if ( distance != m_CurrentDistance )
         {
-            float scale = LinearConversion( 2000, 100, distance, 0.6, 1 );
-            m_MarkerFrame.SetSize( m_OriginalWidth * scale, m_OriginalHeight * scale );
+            m_CurrentDistance = distance;
+            m_MarkerDistanceText.SetText( distance.ToString() + "m" );
+
+            //scale widget from the distance of player
+            if ( m_MarkerFrame )
+            {
+                float scale = LinearConversion( 2000, 100, distance, 0.6, 1 );
+                m_MarkerFrame.SetSize( m_OriginalWidth * scale, m_OriginalHeight * scale );
+            }
         }
 		
-		if ( layoutRoot )
-        	layoutRoot.SetPos( posRelative[0], posRelative[1] );
+        layoutRoot.SetPos( posRelative[0], posRelative[1] );
     }
 }
\ No newline at end of file
@@ -12,8 +12,32 @@
 
 class Expansion3DMarkerModule: JMModuleBase
 {
-    protected autoptr array< ref Expansion3DMarker > 	m_Markers;
+	//! Hidden markers kept around for reuse instead of recreating their layout
+	static const int MARKER_POOL_SIZE = 32;
+
+	//! Markers closer than this are repositioned every frame, further ones every MARKER_MID_INTERVAL frames
+	static const float MARKER_NEAR_DISTANCE = 300;
+	//! Markers further than this are repositioned every MARKER_FAR_INTERVAL frames
+	static const float MARKER_FAR_DISTANCE = 1000;
+	static const int MARKER_MID_INTERVAL = 2;
+	static const int MARKER_FAR_INTERVAL = 4;
+	//! Bone attached markers use the entity position beyond this distance
+	static const float MARKER_BONE_DISTANCE = 100;
+
+	//! Markers by identity, see CreateMarkers for the keys
+    protected autoptr map< string, ref Expansion3DMarker >	m_Markers;
+	//! Party quick markers by player UID, kept apart so they can be changed without rebuilding every marker
+	protected autoptr map< string, ref Expansion3DMarker >	m_QuickMarkers;
+	protected autoptr array< ref Expansion3DMarker >	m_MarkerPool;
 	protected bool										m_ShowMarkers;
+	protected int										m_Frame;
+	protected int										m_UpdateCursor;
+	protected int										m_UpdateBudget;
+
+	//! Camera state of the current frame, shared by every marker
+	protected vector									m_CameraPosition;
+	protected vector									m_CameraDirection;
+	protected float										m_CullCosine;
 	protected bool										m_ShowOnlyPartyMembersMarkers;
 	
 	// ------------------------------------------------------------
@@ -21,9 +45,13 @@ class Expansion3DMarkerModule: JMModuleBase
 	// ------------------------------------------------------------
     void Expansion3DMarkerModule()
     {
-        m_Markers = new array< ref Expansion3DMarker >;
+        m_Markers = new map< string, ref Expansion3DMarker >;
+		m_QuickMarkers = new map< string, ref Expansion3DMarker >;
+		m_MarkerPool = new array< ref Expansion3DMarker >;
 		m_ShowMarkers = true;
 		m_ShowOnlyPartyMembersMarkers = false;
+		m_Frame = 0;
+		m_UpdateCursor = 0;
     }
 	
 	void ToggleShowMarkers()
@@ -84,33 +112,87 @@ class Expansion3DMarkerModule: JMModuleBase
     }
 	
 	// ------------------------------------------------------------
-	// Expansion ClearMarkers
+	// Expansion AcquireMarker
+	// Returns the marker of the given key, reusing the previous one or a pooled one when possible
 	// ------------------------------------------------------------
-    private void ClearMarkers()
-    {
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("Expansion3DMarkerModule::ClearMarkers - Start");
-		#endif
-		
-        while ( m_Markers.Count() > 0 )
-        {
-			delete m_Markers.Get(m_Markers.Count() - 1);
-            m_Markers.Remove(m_Markers.Count() - 1);
-        }
+	private Expansion3DMarker AcquireMarker( map< string, ref Expansion3DMarker > markers, string key, map< string, ref Expansion3DMarker > previous = NULL )
+	{
+		Expansion3DMarker marker = markers.Get( key );
+		if ( marker )
+			return marker;
 
-        m_Markers.Clear();
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("Expansion3DMarkerModule::ClearMarkers - End");
-		#endif
-    }
+		if ( previous )
+		{
+			marker = previous.Get( key );
+			if ( marker )
+			{
+				markers.Insert( key, marker );
+				previous.Remove( key );
+				return marker;
+			}
+		}
+
+		int last = m_MarkerPool.Count() - 1;
+		if ( last >= 0 )
+		{
+			marker = m_MarkerPool[last];
+			markers.Insert( key, marker );
+			m_MarkerPool.Remove( last );
+			return marker;
+		}
+
+		marker = new Expansion3DMarker();
+		markers.Insert( key, marker );
+		return marker;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion ReleaseMarker
+	// Hides the marker and keeps it for reuse while the pool has room
+	// ------------------------------------------------------------
+	private void ReleaseMarker( Expansion3DMarker marker )
+	{
+		if ( !marker )
+			return;
+
+		marker.Release();
+
+		if ( m_MarkerPool.Count() < MARKER_POOL_SIZE )
+			m_MarkerPool.Insert( marker );
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion ReleaseMarkers
+	// ------------------------------------------------------------
+	private void ReleaseMarkers( map< string, ref Expansion3DMarker > markers )
+	{
+		for ( int i = 0; i < markers.Count(); i++ )
+		{
+			ReleaseMarker( markers.GetElement( i ) );
+		}
+
+		markers.Clear();
+	}
 	
 	// ------------------------------------------------------------
 	// Expansion CreateMarkers
+	// Markers that are still wanted keep their widgets, the others go back to the pool
 	// ------------------------------------------------------------
     private void CreateMarkers()
     {
-        ClearMarkers();
+		map< string, ref Expansion3DMarker > previous = m_Markers;
+		m_Markers = new map< string, ref Expansion3DMarker >;
 
+		AddMarkers( previous );
+
+		ReleaseMarkers( previous );
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion AddMarkers
+	// ------------------------------------------------------------
+    private void AddMarkers( map< string, ref Expansion3DMarker > previous )
+    {
         ExpansionMapMarker marker = null;
         int idx = 0;
 		
@@ -134,7 +216,7 @@ class Expansion3DMarkerModule: JMModuleBase
                 if ( !marker || !marker.Is3DMarker() )
                     continue;
 
-                Create3DMarker( marker.GetMarkerText(), ExpansionMarkerIcons.GetMarkerPath( marker.GetIconIndex() ), marker.GetMarkerColor(), marker.GetMarkerPosition() );
+                Create3DMarker( previous, "client:" + idx, marker.GetMarkerText(), ExpansionMarkerIcons.GetMarkerPath( marker.GetIconIndex() ), marker.GetMarkerColor(), marker.GetMarkerPosition() );
             }
         }
 
@@ -147,7 +229,7 @@ class Expansion3DMarkerModule: JMModuleBase
                 if ( !marker || !marker.Is3DMarker() )
                     continue;
 
-                Create3DMarker( marker.GetMarkerText(), ExpansionMarkerIcons.GetMarkerPath( marker.GetIconIndex() ), marker.GetMarkerColor(), marker.GetMarkerPosition() );
+                Create3DMarker( previous, "server:" + idx, marker.GetMarkerText(), ExpansionMarkerIcons.GetMarkerPath( marker.GetIconIndex() ), marker.GetMarkerColor(), marker.GetMarkerPosition() );
             }
         }
 
@@ -179,27 +261,14 @@ class Expansion3DMarkerModule: JMModuleBase
 						if (partyPlayer && partyPlayer.IsAlive() && vector.Distance( partyPlayer.GetPosition(), selfPosition) <= GetExpansionSettings().GetMap().DistanceForPartyMarkers)
 						{
 							//TODO: add it back when exp hit : GetExpansionClientSettings().RedColorHUDOnTopOfHeadOfPlayers
-							Create3DMarker( currPlayer.Name, "DayZExpansion\\GUI\\icons\\marker\\marker_mapmarker.paa", ARGB( 255, 255, 180, 24), vector.Zero, partyPlayer, "0 0.25 0", partyPlayer.GetBoneIndexByName( "Head" ) );
+							Create3DMarker( previous, "player:" + currPlayer.UID, currPlayer.Name, "DayZExpansion\\GUI\\icons\\marker\\marker_mapmarker.paa", ARGB( 255, 255, 180, 24), vector.Zero, partyPlayer, "0 0.25 0", partyPlayer.GetBoneIndexByName( "Head" ) );
 						}
 		            }
 				}
 			}
         }
 		
-		if ( partyModule.HasParty() && GetExpansionSettings().GetParty().EnableQuickMarker )
-        {
-			ref array<ref ExpansionQuickMarker> quickMarkers = partyModule.GetParty().GetQuickMarkers();
-			if ( quickMarkers )
-			{
-				for ( idx = 0; idx < quickMarkers.Count(); idx++ )
-	            {
-					ref ExpansionQuickMarker quickMarker = quickMarkers[idx];
-	                if ( !quickMarker ) continue;
-					
-					Create3DMarker( "", "DayZExpansion\\GUI\\icons\\marker\\marker_mapmarker.paa", quickMarker.Color, quickMarker.Pos );
-	            }
-			}
-		}
+		CreateQuickMarkers();
 
         if ( partyModule.HasParty() && GetExpansionClientSettings().Show3DPartyMarkers && !m_ShowOnlyPartyMembersMarkers )
         {
@@ -212,7 +281,7 @@ class Expansion3DMarkerModule: JMModuleBase
 	                if ( !partyMarker.Is3DMarker() )
 	                    continue;
 	
-		            Create3DMarker( partyMarker.GetMarkerText(), ExpansionMarkerIcons.GetMarkerPath( partyMarker.GetIconIndex() ), partyMarker.GetMarkerColor(), partyMarker.GetMarkerPosition() );
+		            Create3DMarker( previous, "party:" + idx, partyMarker.GetMarkerText(), ExpansionMarkerIcons.GetMarkerPath( partyMarker.GetIconIndex() ), partyMarker.GetMarkerColor(), partyMarker.GetMarkerPosition() );
 				}
 			}
         }
@@ -222,12 +291,92 @@ class Expansion3DMarkerModule: JMModuleBase
 		#endif
     }
 	
+	// ------------------------------------------------------------
+	// Expansion CanShowQuickMarkers
+	// ------------------------------------------------------------
+	private bool CanShowQuickMarkers()
+	{
+		if ( !GetExpansionClientSettings().Show3DMarkers || !GetExpansionSettings().GetParty().EnableQuickMarker )
+			return false;
+
+		ExpansionPartyModule partyModule = ExpansionPartyModule.Cast( GetModuleManager().GetModule( ExpansionPartyModule ) );
+		return partyModule && partyModule.HasParty() && partyModule.GetParty() != NULL;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion CreateQuickMarkers
+	// ------------------------------------------------------------
+	private void CreateQuickMarkers()
+	{
+		map< string, ref Expansion3DMarker > previous = m_QuickMarkers;
+		m_QuickMarkers = new map< string, ref Expansion3DMarker >;
+
+		AddQuickMarkers( previous );
+
+		ReleaseMarkers( previous );
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion AddQuickMarkers
+	// ------------------------------------------------------------
+	private void AddQuickMarkers( map< string, ref Expansion3DMarker > previous )
+	{
+		if ( !CanShowQuickMarkers() )
+			return;
+
+		ExpansionPartyModule partyModule = ExpansionPartyModule.Cast( GetModuleManager().GetModule( ExpansionPartyModule ) );
+		ref array<ref ExpansionQuickMarker> quickMarkers = partyModule.GetParty().GetQuickMarkers();
+		if ( !quickMarkers )
+			return;
+
+		for ( int i = 0; i < quickMarkers.Count(); i++ )
+		{
+			ExpansionQuickMarker quickMarker = quickMarkers[i];
+			if ( quickMarker )
+				AcquireMarker( m_QuickMarkers, quickMarker.UID, previous ).Set( "", "DayZExpansion\\GUI\\icons\\marker\\marker_mapmarker.paa", quickMarker.Color, quickMarker.Pos );
+		}
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion RefreshQuickMarkers
+	// Rebuilds the party quick markers only
+	// ------------------------------------------------------------
+	void RefreshQuickMarkers()
+	{
+		if ( !IsMissionClient() )
+			return;
+
+		CreateQuickMarkers();
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion UpdateQuickMarker
+	// Creates or moves the quick marker of the given player
+	// ------------------------------------------------------------
+	void UpdateQuickMarker( notnull ExpansionQuickMarker quickMarker )
+	{
+		if ( !IsMissionClient() || !CanShowQuickMarkers() )
+			return;
+
+		AcquireMarker( m_QuickMarkers, quickMarker.UID ).Set( "", "DayZExpansion\\GUI\\icons\\marker\\marker_mapmarker.paa", quickMarker.Color, quickMarker.Pos );
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion RemoveQuickMarker
+	// ------------------------------------------------------------
+	void RemoveQuickMarker( string uid )
+	{
+		ReleaseMarker( m_QuickMarkers.Get( uid ) );
+
+		m_QuickMarkers.Remove( uid );
+	}
+	
 	// ------------------------------------------------------------
 	// Expansion Create3DMarker
 	// ------------------------------------------------------------
-    private void Create3DMarker( string name, string iconpath, int color, vector position, Object linkedObject = NULL, vector offset = "0 0 0", int bone = -1 )
+    private void Create3DMarker( map< string, ref Expansion3DMarker > previous, string key, string name, string iconpath, int color, vector position, Object linkedObject = NULL, vector offset = "0 0 0", int bone = -1 )
     {
-        m_Markers.Insert( new Expansion3DMarker( name, iconpath, color, position, linkedObject, offset, bone ) );
+        AcquireMarker( m_Markers, key, previous ).Set( name, iconpath, color, position, linkedObject, offset, bone );
     }
 	
 	// ------------------------------------------------------------
@@ -241,24 +390,142 @@ class Expansion3DMarkerModule: JMModuleBase
 		EXPrint("Expansion3DMarkerModule::OnUpdate - Start");
 		#endif
 
-		for ( int i = 0; i < m_Markers.Count(); i++ )
+		RemoveLostMarkers( m_Markers );
+		RemoveLostMarkers( m_QuickMarkers );
+
+		//! Looked up once per frame instead of once per marker
+		Hud inGameHUD = GetGame().GetMission().GetHud();
+		if ( !m_ShowMarkers || ( inGameHUD && !inGameHUD.GetHudState() ) )
 		{
-			ref Expansion3DMarker marker = m_Markers[i];
-			if (!marker)
-			{
-				m_Markers.RemoveOrdered(i);
-				//We do i-- because we need to stay at the same position, because we have removed one marker
-				i--;
-				delete marker;
-			}
-			else
-			{
-				marker.Update( timeslice );
-			}
+			HideMarkers( m_Markers );
+			HideMarkers( m_QuickMarkers );
+		}
+		else
+		{
+			m_Frame++;
+
+			UpdateCamera();
+
+			m_UpdateBudget = GetExpansionClientSettings().Max3DMarkersPerFrame;
+			if ( m_UpdateBudget <= 0 )
+				m_UpdateBudget = int.MAX;
+
+			//! Quick markers are few and short lived, they go first
+			UpdateMarkers( m_QuickMarkers, 0 );
+
+			m_UpdateCursor = UpdateMarkers( m_Markers, m_UpdateCursor );
 		}
 		
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("Expansion3DMarkerModule::OnUpdate - End");
 		#endif
     }
+	
+	// ------------------------------------------------------------
+	// Expansion UpdateCamera
+	// ------------------------------------------------------------
+	private void UpdateCamera()
+	{
+		m_CameraPosition = GetGame().GetCurrentCameraPosition();
+		m_CameraDirection = GetGame().GetCurrentCameraDirection();
+
+		int width;
+		int height;
+		GetScreenSize( width, height );
+
+		float aspect = 1;
+		if ( height > 0 )
+		{
+			aspect = width;
+			aspect /= height;
+		}
+
+		//! Cone around the view direction that contains the whole frustum, through its corners
+		float tanVertical = Math.Tan( Camera.GetCurrentFOV() * 0.5 );
+		float tanHorizontal = tanVertical * aspect;
+		float tanDiagonal = Math.Sqrt( tanVertical * tanVertical + tanHorizontal * tanHorizontal );
+
+		m_CullCosine = 1 / Math.Sqrt( 1 + tanDiagonal * tanDiagonal );
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion RemoveLostMarkers
+	// ------------------------------------------------------------
+	private void RemoveLostMarkers( map< string, ref Expansion3DMarker > markers )
+	{
+		for ( int i = markers.Count() - 1; i >= 0; i-- )
+		{
+			Expansion3DMarker marker = markers.GetElement( i );
+			if ( !marker || marker.HasLostLinkedObject() )
+			{
+				//! Linked object is gone, the marker comes back on the next refresh if it still exists
+				ReleaseMarker( marker );
+				markers.RemoveElement( i );
+			}
+		}
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion HideMarkers
+	// ------------------------------------------------------------
+	private void HideMarkers( map< string, ref Expansion3DMarker > markers )
+	{
+		for ( int i = 0; i < markers.Count(); i++ )
+		{
+			markers.GetElement( i ).Hide();
+		}
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion UpdateMarkers
+	// Markers outside of the view are hidden without projecting them, the others are
+	// repositioned at a rate depending on their distance until the frame budget is used.
+	// Starts at the given index and returns where the next frame should start.
+	// ------------------------------------------------------------
+	private int UpdateMarkers( map< string, ref Expansion3DMarker > markers, int start )
+	{
+		int count = markers.Count();
+		if ( count == 0 )
+			return 0;
+
+		if ( start >= count )
+			start = 0;
+
+		for ( int i = 0; i < count; i++ )
+		{
+			int index = ( start + i ) % count;
+			Expansion3DMarker marker = markers.GetElement( index );
+
+			vector position = marker.GetWorldPosition( false );
+			vector toMarker = position - m_CameraPosition;
+			float distance = toMarker.Length();
+
+			if ( vector.Dot( m_CameraDirection, toMarker ) < m_CullCosine * distance )
+			{
+				marker.Hide();
+				continue;
+			}
+
+			int interval = 1;
+			if ( distance > MARKER_FAR_DISTANCE )
+				interval = MARKER_FAR_INTERVAL;
+			else if ( distance > MARKER_NEAR_DISTANCE )
+				interval = MARKER_MID_INTERVAL;
+
+			if ( marker.GetLastUpdateFrame() >= 0 && m_Frame - marker.GetLastUpdateFrame() < interval )
+				continue;
+
+			if ( m_UpdateBudget <= 0 )
+				return index;
+
+			m_UpdateBudget--;
+
+			if ( distance <= MARKER_BONE_DISTANCE )
+				position = marker.GetWorldPosition( true );
+
+			marker.UpdateScreen( position, m_CameraPosition, m_Frame );
+		}
+
+		return start;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,292 @@
+/**
+ * ExpansionCompiledMapping.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2020 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionCompiledMapping
+ * @brief		Objects of one mapping file, either parsed from the .map text format
+ *				or read from its compiled .mapb counterpart.
+ *
+ *				The compiled format is the version, the length and hash of the .map file it was
+ *				compiled from, then four arrays, each read at once: the class names used by the file,
+ *				the class name index of every object, 6 floats per object (position then orientation)
+ *				and the indices of the objects flagged as special. A compiled file whose length or hash
+ *				doesn't match the .map next to it is ignored and the text is parsed instead.
+ **/
+class ExpansionCompiledMapping
+{
+	static const int VERSION = 2;
+
+	int SourceLength;
+	int SourceHash;
+
+	ref TStringArray ClassNames;
+	ref TIntArray Objects;
+	ref TFloatArray Transforms;
+	ref TIntArray SpecialObjects;
+
+	//! Class name to its index in ClassNames, filled by AddObject
+	protected ref map< string, int > m_ClassIndices;
+	//! Special flag of every object, SpecialObjects as a lookup
+	protected ref array< bool > m_SpecialFlags;
+
+	// ------------------------------------------------------------
+	// ExpansionCompiledMapping Constructor
+	// ------------------------------------------------------------
+	void ExpansionCompiledMapping()
+	{
+		ClassNames = new TStringArray;
+		Objects = new TIntArray;
+		Transforms = new TFloatArray;
+		SpecialObjects = new TIntArray;
+
+		m_ClassIndices = new map< string, int >;
+		m_SpecialFlags = new array< bool >;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionCompiledMapping Count
+	// ------------------------------------------------------------
+	int Count()
+	{
+		return Objects.Count();
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionCompiledMapping GetClassName
+	// ------------------------------------------------------------
+	string GetClassName( int index )
+	{
+		return ClassNames[ Objects[index] ];
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionCompiledMapping GetPosition
+	// ------------------------------------------------------------
+	vector GetPosition( int index )
+	{
+		int offset = index * 6;
+		return Vector( Transforms[offset], Transforms[offset + 1], Transforms[offset + 2] );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionCompiledMapping GetOrientation
+	// ------------------------------------------------------------
+	vector GetOrientation( int index )
+	{
+		int offset = index * 6 + 3;
+		return Vector( Transforms[offset], Transforms[offset + 1], Transforms[offset + 2] );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionCompiledMapping IsSpecial
+	// ------------------------------------------------------------
+	bool IsSpecial( int index )
+	{
+		return m_SpecialFlags[index];
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionCompiledMapping AddObject
+	// ------------------------------------------------------------
+	void AddObject( string className, vector position, vector orientation, bool special = false )
+	{
+		int classIndex;
+		if ( !m_ClassIndices.Find( className, classIndex ) )
+		{
+			classIndex = ClassNames.Insert( className );
+			m_ClassIndices.Insert( className, classIndex );
+		}
+
+		if ( special )
+			SpecialObjects.Insert( Objects.Count() );
+
+		Objects.Insert( classIndex );
+		m_SpecialFlags.Insert( special );
+
+		Transforms.Insert( position[0] );
+		Transforms.Insert( position[1] );
+		Transforms.Insert( position[2] );
+		Transforms.Insert( orientation[0] );
+		Transforms.Insert( orientation[1] );
+		Transforms.Insert( orientation[2] );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionCompiledMapping HashLine
+	// ------------------------------------------------------------
+	static int HashLine( int hash, string line )
+	{
+		return hash * 31 + line.Hash();
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionCompiledMapping HashSource
+	// Length and hash of a .map file, without parsing it
+	// ------------------------------------------------------------
+	static bool HashSource( string path, out int length, out int hash )
+	{
+		length = 0;
+		hash = 0;
+
+		FileHandle file = OpenFile( path, FileMode.READ );
+		if ( !file )
+			return false;
+
+		string line;
+		while ( FGets( file, line ) > 0 )
+		{
+			length += line.Length();
+			hash = HashLine( hash, line );
+		}
+
+		CloseFile( file );
+
+		return true;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionCompiledMapping Load
+	// Compiled file first, the text file otherwise
+	// ------------------------------------------------------------
+	static ExpansionCompiledMapping Load( string folder, string name )
+	{
+		ExpansionCompiledMapping mapping = LoadCompiled( folder + name + EXPANSION_MAPPING_COMPILED_EXT, folder + name + EXPANSION_MAPPING_EXT );
+		if ( mapping )
+			return mapping;
+
+		return LoadText( folder + name + EXPANSION_MAPPING_EXT );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionCompiledMapping LoadCompiled
+	// Ignores the file if sourcePath exists and changed since it was compiled
+	// ------------------------------------------------------------
+	static ExpansionCompiledMapping LoadCompiled( string path, string sourcePath = "" )
+	{
+		if ( !FileExist( path ) )
+			return NULL;
+
+		FileSerializer file = new FileSerializer;
+		if ( !file.Open( path, FileMode.READ ) )
+			return NULL;
+
+		ExpansionCompiledMapping mapping = new ExpansionCompiledMapping;
+
+		int version;
+		bool success = file.Read( version ) && version == VERSION;
+		success = success && file.Read( mapping.SourceLength ) && file.Read( mapping.SourceHash );
+		success = success && file.Read( mapping.ClassNames ) && file.Read( mapping.Objects );
+		success = success && file.Read( mapping.Transforms ) && file.Read( mapping.SpecialObjects );
+
+		file.Close();
+
+		if ( !success || mapping.Transforms.Count() != mapping.Objects.Count() * 6 )
+		{
+			#ifdef EXPANSIONEXLOGPRINT
+			EXLogPrint( "ExpansionCompiledMapping::LoadCompiled - Ignoring invalid or outdated file " + path );
+			#endif
+
+			return NULL;
+		}
+
+		int sourceLength;
+		int sourceHash;
+		if ( sourcePath != "" && HashSource( sourcePath, sourceLength, sourceHash ) )
+		{
+			if ( sourceLength != mapping.SourceLength || sourceHash != mapping.SourceHash )
+			{
+				#ifdef EXPANSIONEXLOGPRINT
+				EXLogPrint( "ExpansionCompiledMapping::LoadCompiled - Ignoring " + path + ", " + sourcePath + " changed since it was compiled" );
+				#endif
+
+				return NULL;
+			}
+		}
+
+		int i;
+		for ( i = 0; i < mapping.Objects.Count(); i++ )
+		{
+			if ( mapping.Objects[i] < 0 || mapping.Objects[i] >= mapping.ClassNames.Count() )
+				return NULL;
+
+			mapping.m_SpecialFlags.Insert( false );
+		}
+
+		for ( i = 0; i < mapping.SpecialObjects.Count(); i++ )
+		{
+			int special = mapping.SpecialObjects[i];
+			if ( special < 0 || special >= mapping.Objects.Count() )
+				return NULL;
+
+			mapping.m_SpecialFlags[special] = true;
+		}
+
+		return mapping;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionCompiledMapping LoadText
+	// Lines are "ClassName|x y z|yaw pitch roll|special"
+	// ------------------------------------------------------------
+	static ExpansionCompiledMapping LoadText( string path )
+	{
+		FileHandle file = OpenFile( path, FileMode.READ );
+		if ( !file )
+			return NULL;
+
+		ExpansionCompiledMapping mapping = new ExpansionCompiledMapping;
+
+		string line;
+		TStringArray tokens = new TStringArray;
+
+		while ( FGets( file, line ) > 0 )
+		{
+			mapping.SourceLength += line.Length();
+			mapping.SourceHash = HashLine( mapping.SourceHash, line );
+
+			tokens.Clear();
+			line.Split( "|", tokens );
+
+			if ( tokens.Count() < 3 )
+				continue;
+
+			bool special = tokens.Count() > 3 && tokens[3] == "true";
+
+			mapping.AddObject( tokens[0], tokens[1].ToVector(), tokens[2].ToVector(), special );
+		}
+
+		CloseFile( file );
+
+		return mapping;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionCompiledMapping Save
+	// ------------------------------------------------------------
+	bool Save( string path )
+	{
+		FileSerializer file = new FileSerializer;
+		if ( !file.Open( path, FileMode.WRITE ) )
+			return false;
+
+		file.Write( VERSION );
+		file.Write( SourceLength );
+		file.Write( SourceHash );
+		file.Write( ClassNames );
+		file.Write( Objects );
+		file.Write( Transforms );
+		file.Write( SpecialObjects );
+
+		file.Close();
+
+		return true;
+	}
+}
@@ -18,6 +18,13 @@ class IviesPosition
 
 class ExpansionInteriorBuildingModule: JMModuleBase
 {
+	//! Bump when the format of the cache changes or the prebuilt cache shipped with the mod is outdated.
+	//! The cache of the profile is also rebuilt when it was written by another game or mod version
+	static const int COLLISION_CACHE_VERSION = 2;
+
+	//! The cache is written this long after the last class was added to it
+	static const int COLLISION_CACHE_SAVE_DELAY = 30000;
+
 	protected bool m_IsUnloadingInteriors;
 	protected bool m_IsLoadingInteriors;
 	
@@ -27,6 +34,18 @@ class ExpansionInteriorBuildingModule: JMModuleBase
 	
 	//string is classname of the object, and bool, to know if it has collision or not
 	autoptr map<string, bool> m_CachedCollision;
+
+	//! Classes that couldn't be created, not saved so they are probed again next session
+	protected autoptr set<string> m_FailedCollisionProbes;
+
+	protected bool m_CollisionCacheLoaded;
+	protected bool m_CollisionCacheDirty;
+
+	//! Game and mod version the cache was written with
+	protected string m_CollisionCacheBuild;
+
+	protected int m_CollisionCacheHits;
+	protected int m_CollisionCacheMisses;
 	
 	//Use multimap so you can get log(n) for type and n for position
 	protected autoptr multiMap<string, vector> m_AllSpawnedPositions;
@@ -48,6 +67,10 @@ class ExpansionInteriorBuildingModule: JMModuleBase
 		m_InteriorObjects = new array< Object >;
 		
 		m_CachedCollision = new map<string, bool>;
+		m_FailedCollisionProbes = new set<string>;
+
+		m_CollisionCacheLoaded = false;
+		m_CollisionCacheDirty = false;
 		
 		m_AllSpawnedPositions = new multiMap<string, vector>;
 		
@@ -86,6 +109,9 @@ class ExpansionInteriorBuildingModule: JMModuleBase
 		super.OnMissionFinish();
 		
 		UnloadAllInteriors();
+
+		GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).Remove( SaveCachedCollisions );
+		SaveCachedCollisions();
 		
 		//just to be sure it's cleared correctly
 		m_InteriorObjects.Clear();
@@ -273,28 +299,216 @@ class ExpansionInteriorBuildingModule: JMModuleBase
 		}
 	}
 	
+	// ------------------------------------------------------------
+	// Expansion GetCollisionClass
+	// The class is only probed if it's not cached yet. Returns false when it can't be created,
+	// such classes are only remembered for the session and aren't written to the cache
+	// ------------------------------------------------------------
+	bool GetCollisionClass( string type, out bool hasCollision )
+	{
+		LoadCachedCollisions();
+
+		if ( m_CachedCollision.Find( type, hasCollision ) )
+		{
+			m_CollisionCacheHits++;
+			return true;
+		}
+
+		if ( m_FailedCollisionProbes.Find( type ) != -1 )
+			return false;
+
+		m_CollisionCacheMisses++;
+
+		if ( !ProbeCollision( type, hasCollision ) )
+		{
+			m_FailedCollisionProbes.Insert( type );
+			return false;
+		}
+
+		m_CachedCollision.Insert( type, hasCollision );
+
+		RequestSaveCachedCollisions();
+
+		return true;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion ProbeCollision
+	// ------------------------------------------------------------
+	protected bool ProbeCollision( string type, out bool hasCollision )
+	{
+		hasCollision = false;
+
+		Object obj = GetGame().CreateObject_WIP( type, "0 0 0", ECE_CREATEPHYSICS | ECE_CREATELOCAL );
+		if ( !obj )
+			return false;
+
+		//! Don't let the probe queue its own interior
+		BuildingBase buildingBase = BuildingBase.Cast( obj );
+		if ( buildingBase )
+			buildingBase.RemoveFromInteriorsBuildings();
+
+		vector minMax[2];
+		hasCollision = obj.GetCollisionBox( minMax );
+
+		GetGame().ObjectDelete( obj );
+
+		return true;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion PrebuildCollisionCache
+	// Probes every class not cached yet and writes the cache to the given path
+	// ------------------------------------------------------------
+	void PrebuildCollisionCache( TStringArray classNames, string path )
+	{
+		LoadCachedCollisions();
+
+		int probed = 0;
+
+		for ( int i = 0; i < classNames.Count(); i++ )
+		{
+			if ( m_CachedCollision.Contains( classNames[i] ) )
+				continue;
+
+			bool hasCollision;
+			if ( !ProbeCollision( classNames[i], hasCollision ) )
+				continue;
+
+			m_CachedCollision.Insert( classNames[i], hasCollision );
+			probed++;
+		}
+
+		m_CollisionCacheDirty = true;
+
+		WriteCachedCollisions( path );
+
+		Print( "[ExpansionInteriorBuildingModule] Collision cache prebuilt: " + classNames.Count() + " classes, " + probed + " probed, " + m_CachedCollision.Count() + " cached, written to " + path );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetCollisionCacheHits
+	// ------------------------------------------------------------
+	int GetCollisionCacheHits()
+	{
+		return m_CollisionCacheHits;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetCollisionCacheMisses
+	// ------------------------------------------------------------
+	int GetCollisionCacheMisses()
+	{
+		return m_CollisionCacheMisses;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion RequestSaveCachedCollisions
+	// Delays the write so a whole loading pass only saves once
+	// ------------------------------------------------------------
+	void RequestSaveCachedCollisions()
+	{
+		m_CollisionCacheDirty = true;
+
+		GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).Remove( SaveCachedCollisions );
+		GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).CallLater( SaveCachedCollisions, COLLISION_CACHE_SAVE_DELAY );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion SaveCachedCollisions
+	// Only writes when classes were added since the last save
+	// ------------------------------------------------------------
 	void SaveCachedCollisions()
+	{
+		if ( !m_CollisionCacheDirty )
+			return;
+
+		WriteCachedCollisions( EXPANSION_COLLISION_CACHE );
+
+		#ifdef EXPANSIONEXLOGPRINT
+		EXLogPrint("ExpansionInteriorBuildingModule::SaveCachedCollisions - classes : " + m_CachedCollision.Count() + " hits : " + m_CollisionCacheHits + " misses : " + m_CollisionCacheMisses);
+		#endif
+	}
+
+	// ------------------------------------------------------------
+	// Expansion WriteCachedCollisions
+	// ------------------------------------------------------------
+	protected void WriteCachedCollisions( string path )
 	{
 		FileSerializer file = new FileSerializer;
 			
-		if (file.Open(EXPANSION_TEMP_INTERIORS, FileMode.WRITE ))
+		if ( file.Open( path, FileMode.WRITE ) )
 		{
-			file.Write(m_CachedCollision);
+			file.Write( COLLISION_CACHE_VERSION );
+			file.Write( GetCollisionCacheBuild() );
+			file.Write( m_CachedCollision );
 			file.Close();
+
+			m_CollisionCacheDirty = false;
 		}
 	}
 	
+	// ------------------------------------------------------------
+	// Expansion GetCollisionCacheBuild
+	// ------------------------------------------------------------
+	protected string GetCollisionCacheBuild()
+	{
+		if ( m_CollisionCacheBuild != "" )
+			return m_CollisionCacheBuild;
+
+		string gameVersion;
+		GetGame().GetVersion( gameVersion );
+
+		m_CollisionCacheBuild = gameVersion + " " + LoadingScreen.GetClientExpansionVersion();
+
+		return m_CollisionCacheBuild;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion LoadCachedCollisions
+	// Loaded once per session, the cache shipped with the mod first then the one of the profile.
+	// The shipped cache only has to match COLLISION_CACHE_VERSION so it survives game updates
+	// ------------------------------------------------------------
 	void LoadCachedCollisions()
 	{
-		if (FileExist(EXPANSION_TEMP_INTERIORS))
+		if ( m_CollisionCacheLoaded )
+			return;
+
+		m_CollisionCacheLoaded = true;
+
+		ReadCachedCollisions( EXPANSION_COLLISION_CACHE_PREBUILT, false );
+		ReadCachedCollisions( EXPANSION_COLLISION_CACHE, true );
+
+		#ifdef EXPANSIONEXLOGPRINT
+		EXLogPrint("ExpansionInteriorBuildingModule::LoadCachedCollisions - classes : " + m_CachedCollision.Count());
+		#endif
+	}
+
+	// ------------------------------------------------------------
+	// Expansion ReadCachedCollisions
+	// A cache of another version is ignored and rebuilt, as is one written by another game or mod version when checkBuild is set
+	// ------------------------------------------------------------
+	protected void ReadCachedCollisions( string path, bool checkBuild )
+	{
+		if ( !FileExist( path ) )
+			return;
+
+		FileSerializer file = new FileSerializer;
+		if ( !file.Open( path, FileMode.READ ) )
+			return;
+
+		int version;
+		string build;
+		map<string, bool> cached = new map<string, bool>;
+
+		if ( file.Read( version ) && version == COLLISION_CACHE_VERSION && file.Read( build ) && ( !checkBuild || build == GetCollisionCacheBuild() ) && file.Read( cached ) )
 		{
-			FileSerializer file = new FileSerializer;
-			
-			if (file.Open(EXPANSION_TEMP_INTERIORS, FileMode.READ ))
+			for ( int i = 0; i < cached.Count(); i++ )
 			{
-				file.Read(m_CachedCollision);
-				file.Close();
+				m_CachedCollision.Set( cached.GetKey( i ), cached.GetElement( i ) );
 			}
 		}
+
+		file.Close();
 	}
-}
\ No newline at end of file
+}
@@ -21,6 +21,13 @@ enum ExpansionWorldMappingModuleRPC
 
 class ExpansionWorldMappingModule: JMModuleBase
 {
+	//! Mapping objects spawned per update while mappings are loading
+	static const int MAPPING_OBJECTS_PER_UPDATE = 150;
+	//! Spawned buildings whose doors get checked per update
+	static const int MAPPING_DOORS_PER_UPDATE = 20;
+	//! Pathgraph updates of spawned objects are merged per cell of this size
+	static const float PATHGRAPH_CELL_SIZE = 64;
+
 	static ref ScriptInvoker SI_LampEnable = new ScriptInvoker();
 	static ref ScriptInvoker SI_LampDisable = new ScriptInvoker();
 
@@ -28,6 +35,19 @@ class ExpansionWorldMappingModule: JMModuleBase
 
     private autoptr map< string, ref array< Object > > m_Objects;
     private string m_WorldName;
+
+	//! Incremental loading state, files are reserved in m_Objects as soon as they are queued
+	private autoptr TStringArray m_PendingMappings;
+	private ref ExpansionCompiledMapping m_LoadingMapping;
+	private string m_LoadingName;
+	private int m_LoadingIndex;
+	private ref array< Object > m_LoadingObjects;
+	private int m_LoadedFiles;
+	private int m_TotalFiles;
+
+	private autoptr array< Building > m_PendingDoors;
+	private autoptr map< int, vector > m_PathgraphMin;
+	private autoptr map< int, vector > m_PathgraphMax;
 	
 	protected ExpansionInteriorBuildingModule m_InteriorModule
  	
@@ -43,6 +63,11 @@ class ExpansionWorldMappingModule: JMModuleBase
 		m_LightGenerators = new array< vector >;
 
         m_Objects = new map< string, ref array< Object > >;
+
+		m_PendingMappings = new TStringArray;
+		m_PendingDoors = new array< Building >;
+		m_PathgraphMin = new map< int, vector >;
+		m_PathgraphMax = new map< int, vector >;
 		
 		ExpansionSettings.SI_General.Insert( OnSettingsUpdated );
 		
@@ -108,6 +133,9 @@ class ExpansionWorldMappingModule: JMModuleBase
 		EXPrint("ExpansionWorldMappingModule::OnMissionFinish - Start");
 		#endif
 		
+		m_PendingMappings.Clear();
+		m_PendingDoors.Clear();
+
         UnloadMapping( m_Objects.GetKeyArray() );
 		
 		#ifdef EXPANSIONEXPRINT
@@ -208,6 +236,7 @@ class ExpansionWorldMappingModule: JMModuleBase
 	
 	// ------------------------------------------------------------
 	// Expansion LoadMapping
+	// Queues the files, their objects are spawned over the next updates
 	// ------------------------------------------------------------	
     private void LoadMapping( TStringArray files )
     {
@@ -215,23 +244,237 @@ class ExpansionWorldMappingModule: JMModuleBase
 		EXLogPrint("ExpansionWorldMappingModule::LoadMapping - Start files.Count() : " + files.Count());
 		#endif
 		
-		if ( m_InteriorModule )
+		if ( !m_InteriorModule || files.Count() == 0 )
+			return;
+
+		if ( !IsLoadingMappings() )
 		{
 			m_InteriorModule.LoadCachedCollisions();
-			
-			for ( int i = 0; i < files.Count(); ++i )
-	        {
-				LoadFile( files[i] );
-	        }
-			
-			m_InteriorModule.SaveCachedCollisions();
+
+			m_LoadedFiles = 0;
+			m_TotalFiles = 0;
 		}
+
+		for ( int i = 0; i < files.Count(); ++i )
+		{
+			if ( m_Objects.Contains( files[i] ) )
+				continue;
+
+			m_Objects.Insert( files[i], new array< Object > );
+			m_PendingMappings.Insert( files[i] );
+			m_TotalFiles++;
+		}
+
+		UpdateLoadingProgress();
 		
 		#ifdef EXPANSIONEXLOGPRINT
 		EXLogPrint("ExpansionWorldMappingModule::LoadMapping - End");
 		#endif
     }
 	
+	// ------------------------------------------------------------
+	// Expansion IsLoadingMappings
+	// ------------------------------------------------------------	
+	bool IsLoadingMappings()
+	{
+		return m_LoadingMapping != NULL || m_PendingMappings.Count() > 0;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion GetLoadingProgress
+	// Between 0 and 1, the current file counts by the share of its objects spawned
+	// ------------------------------------------------------------	
+	float GetLoadingProgress()
+	{
+		if ( m_TotalFiles == 0 )
+			return 1;
+
+		float loaded = m_LoadedFiles;
+		if ( m_LoadingMapping && m_LoadingMapping.Count() > 0 )
+		{
+			float spawned = m_LoadingIndex;
+			loaded += spawned / m_LoadingMapping.Count();
+		}
+
+		return loaded / m_TotalFiles;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion UpdateLoadingProgress
+	// ------------------------------------------------------------	
+	private void UpdateLoadingProgress()
+	{
+		if ( !IsMissionClient() )
+			return;
+
+		LoadingScreen.ExpansionSetMappingProgress( IsLoadingMappings(), GetLoadingProgress() );
+	}
+	
+	// ------------------------------------------------------------
+	// Override OnUpdate
+	// ------------------------------------------------------------	
+	override void OnUpdate( float timeslice )
+	{
+		super.OnUpdate( timeslice );
+
+		CheckPendingDoors();
+
+		if ( !IsLoadingMappings() )
+			return;
+
+		int budget = MAPPING_OBJECTS_PER_UPDATE;
+		while ( budget > 0 )
+		{
+			if ( !m_LoadingMapping && !StartNextFile() )
+			{
+				FinishLoadingMappings();
+				return;
+			}
+
+			//! The file got unloaded in the meantime, its spawned objects are already deleted
+			if ( m_Objects.Get( m_LoadingName ) != m_LoadingObjects )
+			{
+				m_LoadingMapping = NULL;
+				m_LoadingObjects = NULL;
+				m_LoadedFiles++;
+				continue;
+			}
+
+			if ( m_LoadingIndex >= m_LoadingMapping.Count() )
+			{
+				#ifdef EXPANSIONEXLOGPRINT
+				EXLogPrint("ExpansionWorldMappingModule::OnUpdate - Loaded file : " + m_LoadingName + " objects : " + m_LoadingObjects.Count());
+				#endif
+
+				m_LoadingMapping = NULL;
+				m_LoadingObjects = NULL;
+				m_LoadedFiles++;
+				continue;
+			}
+
+			SpawnObject( m_LoadingMapping, m_LoadingIndex++, m_LoadingObjects );
+			budget--;
+		}
+
+		UpdateLoadingProgress();
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion StartNextFile
+	// ------------------------------------------------------------	
+	private bool StartNextFile()
+	{
+		while ( m_PendingMappings.Count() > 0 )
+		{
+			string name = m_PendingMappings[0];
+			m_PendingMappings.RemoveOrdered( 0 );
+
+			//! Unloaded before it was started
+			if ( !m_Objects.Contains( name ) )
+			{
+				m_LoadedFiles++;
+				continue;
+			}
+
+			ExpansionCompiledMapping mapping = LoadMappingObjects( name );
+			if ( !mapping )
+			{
+				m_LoadedFiles++;
+				continue;
+			}
+
+			m_LoadingMapping = mapping;
+			m_LoadingName = name;
+			m_LoadingIndex = 0;
+			m_LoadingObjects = m_Objects.Get( name );
+
+			return true;
+		}
+
+		return false;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion FinishLoadingMappings
+	// ------------------------------------------------------------	
+	private void FinishLoadingMappings()
+	{
+		#ifdef EXPANSIONEXLOGPRINT
+		EXLogPrint("ExpansionWorldMappingModule::FinishLoadingMappings - files : " + m_TotalFiles + " pathgraph cells : " + m_PathgraphMin.Count());
+		#endif
+
+		m_LoadingMapping = NULL;
+		m_LoadingObjects = NULL;
+
+		for ( int i = 0; i < m_PathgraphMin.Count(); i++ )
+		{
+			int cell = m_PathgraphMin.GetKey( i );
+			GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).CallLater( GetGame().UpdatePathgraphRegion, 100, false, m_PathgraphMin.GetElement( i ), m_PathgraphMax.Get( cell ) );
+		}
+
+		m_PathgraphMin.Clear();
+		m_PathgraphMax.Clear();
+
+		UpdateLoadingProgress();
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion QueuePathgraphUpdate
+	// Grows the region of the cell the object is in, regions are updated once everything is loaded
+	// ------------------------------------------------------------	
+	private void QueuePathgraphUpdate( Object obj )
+	{
+		vector position = obj.GetPosition();
+
+		float radius = 0;
+		vector minMax[2];
+		if ( obj.GetCollisionBox( minMax ) )
+			radius = vector.Distance( minMax[0], minMax[1] ) * 0.5;
+
+		vector extent = Vector( radius, radius, radius );
+		vector regionMin = position - extent;
+		vector regionMax = position + extent;
+
+		int cell = Math.Floor( position[0] / PATHGRAPH_CELL_SIZE ) * 4096 + Math.Floor( position[2] / PATHGRAPH_CELL_SIZE );
+
+		vector cellMin;
+		vector cellMax;
+		if ( m_PathgraphMin.Find( cell, cellMin ) )
+		{
+			cellMax = m_PathgraphMax.Get( cell );
+
+			for ( int i = 0; i < 3; i++ )
+			{
+				regionMin[i] = Math.Min( regionMin[i], cellMin[i] );
+				regionMax[i] = Math.Max( regionMax[i], cellMax[i] );
+			}
+		}
+
+		m_PathgraphMin.Set( cell, regionMin );
+		m_PathgraphMax.Set( cell, regionMax );
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion CheckPendingDoors
+	// ------------------------------------------------------------	
+	private void CheckPendingDoors()
+	{
+		int count = Math.Min( m_PendingDoors.Count(), MAPPING_DOORS_PER_UPDATE );
+		if ( count == 0 )
+			return;
+
+		for ( int i = 0; i < count; i++ )
+		{
+			CheckDoors( m_PendingDoors[i] );
+		}
+
+		//! Oldest first, the array only holds what was spawned since the previous update
+		for ( int j = count - 1; j >= 0; j-- )
+		{
+			m_PendingDoors.RemoveOrdered( j );
+		}
+	}
+	
 	// ------------------------------------------------------------
 	// Expansion UnloadMapping
 	// ------------------------------------------------------------	
@@ -314,33 +557,11 @@ class ExpansionWorldMappingModule: JMModuleBase
     }
     
     // ------------------------------------------------------------
-	// Expansion GetObjectFromFile
+	// Expansion LoadMappingObjects
 	// ------------------------------------------------------------
-	private bool GetObjectFromFile( FileHandle file, out string name, out vector position, out vector rotation, out string special = "false" )
+	private ExpansionCompiledMapping LoadMappingObjects( string name )
 	{
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionWorldMappingModule::GetObjectFromFile - Start");
-		#endif
-		
-		string line;
-		int lineSize = FGets( file, line );
-	
-		if ( lineSize < 1 )
-			return false;
-		
-		TStringArray tokens = new TStringArray;
-		line.Split( "|", tokens );
-
-		name = tokens.Get( 0 );
-		position = tokens.Get( 1 ).ToVector();
-		rotation = tokens.Get( 2 ).ToVector();
-		special = tokens.Get( 3 );
-		
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionWorldMappingModule::GetObjectFromFile - End");
-		#endif
-
-		return true;
+		return ExpansionCompiledMapping.Load( EXPANSION_MAPPING_FOLDER + m_WorldName + "/", name );
 	}
 	
 	// ------------------------------------------------------------
@@ -356,123 +577,80 @@ class ExpansionWorldMappingModule: JMModuleBase
 	}
 	
 	// ------------------------------------------------------------
-	// Expansion LoadFile
+	// Expansion SpawnObject
 	// ------------------------------------------------------------
-	private void LoadFile( string name )
+	private void SpawnObject( ExpansionCompiledMapping mapping, int i, array< Object > objects )
 	{
-		#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionWorldMappingModule::LoadFile - Start name : " + name);
-		#endif
-
-		string className;
-		vector position;
-		vector rotation;
-		string special;
+		string className = mapping.GetClassName( i );
+		vector position = mapping.GetPosition( i );
+		vector rotation = mapping.GetOrientation( i );
 
-        string filePath = EXPANSION_MAPPING_FOLDER + m_WorldName + "/" + name + EXPANSION_MAPPING_EXT;
-		FileHandle file = OpenFile( filePath, FileMode.READ );
-	
-		if ( !file )
+		bool collisionBox = false;
+		
+		if ( !m_InteriorModule.GetCollisionClass( className, collisionBox ) )
 			return;
-
-        array< Object > objects = new array< Object >;
 		
-		while ( GetObjectFromFile( file, className, position, rotation, special ) )
-		{
-			bool collisionBox = false;
-			
-			Object obj;
-			if (!m_InteriorModule.m_CachedCollision.Find(className, collisionBox))
-			{
-				obj = GetGame().CreateObject_WIP( className, position, ECE_CREATEPHYSICS | ECE_CREATELOCAL );
-				if ( !obj )
-				{
-					m_InteriorModule.m_CachedCollision.Insert( className, false );
-					continue;
-				}
-				
-				BuildingBase buildingBase = BuildingBase.Cast(obj);
-				if (buildingBase)
-					buildingBase.RemoveFromInteriorsBuildings();
-				
-				vector minMax[2];
-				collisionBox = obj.GetCollisionBox(minMax);
-				
-				m_InteriorModule.m_CachedCollision.Insert(className, collisionBox);
-				
-				GetGame().ObjectDelete(obj);
-			}
-			
-			#ifdef EXPANSIONEXPRINT
-		EXPrint( "ExpansionWorldMappingModule::LoadFile Attempt to create object " + className + " collision : " + collisionBox + " at " + position + " from file:" + filePath + ".");
+		#ifdef EXPANSIONEXPRINT
+		EXPrint( "ExpansionWorldMappingModule::SpawnObject Attempt to create object " + className + " collision : " + collisionBox + " at " + position + " from file:" + m_LoadingName + ".");
 		#endif
 
-            //Only spawn object with collision at server side, and object without collision at client side 
-			if (collisionBox && IsMissionClient() && GetGame().IsMultiplayer()) continue;
-			if (!collisionBox && IsMissionHost() && GetGame().IsMultiplayer()) continue;
-			
-			// don't use CreateObject, it does a bunch of unnecessary stuff
-			int flags = ECE_CREATEPHYSICS;
-			if ( IsMissionClient() )
-				flags |= ECE_CREATELOCAL; // create_local
-			
-			obj = GetGame().CreateObject_WIP( className, position, flags );
-			if ( !obj )
-				continue;
-			
-			#ifdef EXPANSIONEXPRINT
-		EXPrint( "ExpansionWorldMappingModule::LoadFile Created object " + className + " collision : " + collisionBox + " at " + position + " from file:" + filePath + ".");
+        //Only spawn object with collision at server side, and object without collision at client side 
+		if (collisionBox && IsMissionClient() && GetGame().IsMultiplayer()) return;
+		if (!collisionBox && IsMissionHost() && GetGame().IsMultiplayer()) return;
+		
+		// don't use CreateObject, it does a bunch of unnecessary stuff
+		int flags = ECE_CREATEPHYSICS;
+		if ( IsMissionClient() )
+			flags |= ECE_CREATELOCAL; // create_local
+		
+		Object obj = GetGame().CreateObject_WIP( className, position, flags );
+		if ( !obj )
+			return;
+		
+		#ifdef EXPANSIONEXPRINT
+		EXPrint( "ExpansionWorldMappingModule::SpawnObject Created object " + className + " collision : " + collisionBox + " at " + position + " from file:" + m_LoadingName + ".");
 		#endif
-			
-			//Tell engine it will represent static object
-			obj.SetFlags(EntityFlags.STATIC, false);
-						
-			obj.SetPosition( position );
-			obj.SetOrientation( rotation );
-			
-			FixObjectCollision( obj );
+		
+		//Tell engine it will represent static object
+		obj.SetFlags(EntityFlags.STATIC, false);
+					
+		obj.SetPosition( position );
+		obj.SetOrientation( rotation );
+		
+		FixObjectCollision( obj );
 
-			if ( obj.CanAffectPathgraph() )
-			{
-				obj.SetAffectPathgraph( true, false );
-				GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).CallLater( GetGame().UpdatePathgraphRegionByObject, 100, false, obj );
-			}
-			
-			EntityAI entityAI = EntityAI.Cast( obj );
-			if ( entityAI )
-			{
-				//Make it not CE saved	
-				if (IsMissionHost()) entityAI.SetLifetime(1.0);
-			}
-			
-			Building building = Building.Cast( obj );
-			if ( building )
-			{
-				GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).CallLater( this.CheckDoors, 100, false, building );
-			}
-			else
+		if ( obj.CanAffectPathgraph() )
+		{
+			obj.SetAffectPathgraph( true, false );
+			QueuePathgraphUpdate( obj );
+		}
+		
+		EntityAI entityAI = EntityAI.Cast( obj );
+		if ( entityAI )
+		{
+			//Make it not CE saved	
+			if (IsMissionHost()) entityAI.SetLifetime(1.0);
+		}
+		
+		Building building = Building.Cast( obj );
+		if ( building )
+		{
+			m_PendingDoors.Insert( building );
+		}
+		else
+		{
+			ItemBase item = ItemBase.Cast( obj );
+			if (item)
 			{
-				ItemBase item = ItemBase.Cast( obj );
-				if (item)
-				{
-					//Make it not takeable
-					item.SetTakeable( false );
-				}
+				//Make it not takeable
+				item.SetTakeable( false );
 			}
-			
-			if ( special == "true")
-				ProcessObject( obj );
-			
-			objects.Insert( obj );
 		}
-
-        m_Objects.Insert( name, objects );
-
-		CloseFile( file );
-
-		#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionWorldMappingModule::LoadFile - End name : " + name);
-		#endif
+		
+		if ( mapping.IsSpecial( i ) )
+			ProcessObject( obj );
+		
+		objects.Insert( obj );
 	}
 		
 	// ------------------------------------------------------------
@@ -612,18 +790,16 @@ class ExpansionWorldMappingModule: JMModuleBase
 		#endif
 
 		Object obj;
-		string className;
-		vector position;
-		vector rotation;
 
-        string filePath = EXPANSION_MAPPING_FOLDER + m_WorldName + "/" + name + EXPANSION_MAPPING_EXT;
-		FileHandle file = OpenFile( filePath, FileMode.READ );
-	
-		if ( !file )
+		ExpansionCompiledMapping mapping = LoadMappingObjects( name );
+		if ( !mapping )
 			return;
 		
-		while ( GetObjectFromFile( file, className, position, rotation ) )
+		for ( int i = 0; i < mapping.Count(); i++ )
 		{
+			string className = mapping.GetClassName( i );
+			vector position = mapping.GetPosition( i );
+
 	        array<Object> objects = new array<Object>;
 			array<CargoBase> proxies = new array<CargoBase>;
 			
@@ -647,10 +823,8 @@ class ExpansionWorldMappingModule: JMModuleBase
 			proxies.Clear();
 		}
 
-		CloseFile( file );
-
 		#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint( "Created all objects from mapping file: " + filePath );
+		EXLogPrint( "Created all objects from mapping file: " + name );
 		#endif
 
 		#ifdef EXPANSIONEXPRINT
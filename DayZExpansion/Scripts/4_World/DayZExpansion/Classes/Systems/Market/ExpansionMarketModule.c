@@ -12,6 +12,9 @@
 
 class ExpansionMarketModule: JMModuleBase
 {	
+	//! Interval in ms at which changed trader zones and categories are written to disk
+	static const int MARKET_SAVE_INTERVAL = 60000;
+
 	static ref ScriptInvoker SI_SetTraderInvoker = new ScriptInvoker();
 	static ref ScriptInvoker SI_SelectedItemUpdatedInvoker = new ScriptInvoker();
 	static ref ScriptInvoker SI_Callback = new ScriptInvoker();
@@ -21,11 +24,16 @@ class ExpansionMarketModule: JMModuleBase
 
 	ref map< string, ExpansionMarketCurrency > m_MoneyTypes;
 	ref array< string >	m_MoneyDenominations;
+	//! Lowercase money class name -> index in m_MoneyDenominations
+	ref map< string, int > m_MoneyDenominationIndices;
 
 	protected ref array< ref ExpansionMarketNetworkItem > m_NetworkItems;
 	protected ref ExpansionMarketTraderZone m_ClientMarketZone;
 	
 	protected ExpansionTraderBase m_OpenedClientTrader;
+
+	//! Server: last trader stock snapshot sent to each player, by identity id
+	protected ref map< string, ref ExpansionMarketTraderViewer > m_TraderViewers;
 	
 	// ------------------------------------------------------------
 	// ExpansionMarketModule Constructor
@@ -37,10 +45,13 @@ class ExpansionMarketModule: JMModuleBase
 
 		m_MoneyTypes = new map< string, ExpansionMarketCurrency >;
 		m_MoneyDenominations = new array< string >;
+		m_MoneyDenominationIndices = new map< string, int >;
 
 		m_NetworkItems = new array< ref ExpansionMarketNetworkItem >;
 
 		m_ClientMarketZone = new ExpansionMarketClientTraderZone;
+
+		m_TraderViewers = new map< string, ref ExpansionMarketTraderViewer >;
 	}
 	
 	// ------------------------------------------------------------
@@ -52,6 +63,17 @@ class ExpansionMarketModule: JMModuleBase
 
 		LoadMoneyPrice();
 	}
+
+	// ------------------------------------------------------------
+	// Override OnMissionStart
+	// ------------------------------------------------------------
+	override void OnMissionStart()
+	{
+		super.OnMissionStart();
+
+		if ( IsMissionHost() )
+			GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).CallLater( SaveMarketChanges, MARKET_SAVE_INTERVAL, true );
+	}
 	
 	// ------------------------------------------------------------
 	// Override OnMissionFinish
@@ -60,10 +82,33 @@ class ExpansionMarketModule: JMModuleBase
 	{
 		super.OnMissionFinish();
 
+		if ( IsMissionHost() )
+		{
+			GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).Remove( SaveMarketChanges );
+
+			SaveMarketChanges();
+		}
+
 		m_MoneyTypes.Clear();
 		m_MoneyDenominations.Clear();
+		m_MoneyDenominationIndices.Clear();
+
+		m_TraderViewers.Clear();
 	}
 	
+	// ------------------------------------------------------------
+	// Expansion SaveMarketChanges
+	// Write-behind of the stock changed since the last call, keeps
+	// disk writes out of the purchase and sell path
+	// ------------------------------------------------------------
+	void SaveMarketChanges()
+	{
+		if ( !GetExpansionSettings() || !GetExpansionSettings().GetMarket() )
+			return;
+
+		GetExpansionSettings().GetMarket().SaveDirty();
+	}
+
 	// ------------------------------------------------------------
 	// Expansion GetClientZone
 	// ------------------------------------------------------------
@@ -88,6 +133,27 @@ class ExpansionMarketModule: JMModuleBase
 		return m_MoneyDenominations.Get( index );
 	}
 
+	// ------------------------------------------------------------
+	// Expansion Int GetMoneyDenominationIndex
+	// Returns -1 if the lowercase type is not a money denomination
+	// ------------------------------------------------------------
+	int GetMoneyDenominationIndex( string type )
+	{
+		int index;
+		if ( m_MoneyDenominationIndices.Find( type, index ) )
+			return index;
+
+		return -1;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion Int GetMoneyDenominationCount
+	// ------------------------------------------------------------
+	int GetMoneyDenominationCount()
+	{
+		return m_MoneyDenominations.Count();
+	}
+
 	// ------------------------------------------------------------
 	// Expansion LoadMoneyPrice
 	// ------------------------------------------------------------
@@ -133,6 +199,12 @@ class ExpansionMarketModule: JMModuleBase
         }
 
 		m_MoneyDenominations.Invert();
+
+		m_MoneyDenominationIndices.Clear();
+		for ( i = 0; i < m_MoneyDenominations.Count(); i++ )
+		{
+			m_MoneyDenominationIndices.Insert( m_MoneyDenominations[i], i );
+		}
 	}
 	
 	// ------------------------------------------------------------
@@ -163,7 +235,7 @@ class ExpansionMarketModule: JMModuleBase
 	// ------------------------------------------------------------
 	// Expansion FindSellPrice
 	// ------------------------------------------------------------
-	bool FindSellPrice( notnull PlayerBase player, ExpansionMarketItem item, int stock, int amountWanted, out ExpansionMarketSell sell )
+	bool FindSellPrice( notnull PlayerBase player, ExpansionMarketItem item, int stock, int amountWanted, out ExpansionMarketSell sell, ExpansionMarketPlayerInventory inventory = NULL )
 	{
 		if ( !player )
 		{
@@ -178,8 +250,12 @@ class ExpansionMarketModule: JMModuleBase
 		if ( sell == NULL )
 			sell = player.GetMarketSell();
 
-		array< EntityAI > items = new array< EntityAI >;
-	   	player.GetInventory().EnumerateInventory( InventoryTraversalType.PREORDER, items );
+		if ( !inventory )
+			inventory = new ExpansionMarketPlayerInventory( player, this );
+
+		array< EntityAI > items = inventory.GetItems( item.ClassName );
+		if ( !items )
+			return false;
 
 		Magazine mag;
 
@@ -187,97 +263,90 @@ class ExpansionMarketModule: JMModuleBase
 
 		for ( int i = 0; i < items.Count(); i++ )
 		{
-			EntityAI itementity = EntityAI.Cast( items[i] );
-			string itemClassName = itementity.GetType();
-			
-			itemClassName.ToLower();
-			
-			if ( itemClassName == item.ClassName )
-			{
-				ItemBase itembase = ItemBase.Cast( items[i] );
-				int quantityTaken;
-				int quantityRemaining;
-				bool canSell = true;
-
-				if ( itembase.GetInventory() )
-				{					
-					if ( itembase.GetInventory().AttachmentCount() != 0 )
-					{
-						canSell = false;
-					}
+			ItemBase itembase = ItemBase.Cast( items[i] );
+			int quantityTaken;
+			int quantityRemaining;
+			bool canSell = true;
 
-					if ( itembase.GetInventory().GetCargo() && itembase.GetInventory().GetCargo().GetItemCount() != 0 )
-					{
-						canSell = false;
-					}
+			if ( itembase.GetInventory() )
+			{					
+				if ( itembase.GetInventory().AttachmentCount() != 0 )
+				{
+					canSell = false;
 				}
 
-				if ( canSell )
+				if ( itembase.GetInventory().GetCargo() && itembase.GetInventory().GetCargo().GetItemCount() != 0 )
 				{
-					if ( itembase ) 
+					canSell = false;
+				}
+			}
+
+			if ( canSell )
+			{
+				if ( itembase ) 
+				{
+					if ( IsLiquidItem( itembase ) || itembase.IsFood() || itembase.HasEnergyManager() )
 					{
-						if ( IsLiquidItem( itembase ) || itembase.IsFood() || itembase.HasEnergyManager() )
+						quantityTaken = 1;
+						quantityRemaining = 0;
+					} 
+					else if ( Class.CastTo( mag, itembase ) )
+					{
+						if ( itembase.IsKindOf( "Ammunition_Base" ) )
 						{
-							quantityTaken = 1;
+							quantityTaken = mag.GetAmmoCount();
 							quantityRemaining = 0;
 						} 
-						else if ( Class.CastTo( mag, itembase ) )
+						else
 						{
-							if ( itembase.IsKindOf( "Ammunition_Base" ) )
+							if ( mag.GetAmmoCount() > 0 )
 							{
-								quantityTaken = mag.GetAmmoCount();
-								quantityRemaining = 0;
+								canSell = false;
 							} 
 							else
 							{
-								if ( mag.GetAmmoCount() > 0 )
-								{
-									canSell = false;
-								} 
-								else
-								{
-									quantityTaken = 1;
-									quantityRemaining = 0;
-								}
+								quantityTaken = 1;
+								quantityRemaining = 0;
 							}
-						} 
-						else if ( itembase.HasQuantity() )
-						{
-							quantityTaken = itembase.GetQuantity();
-							quantityRemaining = 0;
-						} 
-						else
-						{
-							quantityTaken = 1;
-							quantityRemaining = 0;
 						}
 					} 
+					else if ( itembase.HasQuantity() )
+					{
+						quantityTaken = itembase.GetQuantity();
+						quantityRemaining = 0;
+					} 
 					else
 					{
 						quantityTaken = 1;
 						quantityRemaining = 0;
 					}
+				} 
+				else
+				{
+					quantityTaken = 1;
+					quantityRemaining = 0;
 				}
+			}
 
-				if ( canSell )
+			if ( canSell )
+			{
+				if ( amountWanted - quantityTaken <= 0 )
 				{
-					if ( amountWanted - quantityTaken <= 0 )
-					{
-						quantityRemaining = quantityTaken - amountWanted;
-						quantityTaken = amountWanted;
-					}
-
-					amountWanted -= quantityTaken;
-					increaseStockBy += quantityTaken;
-
-					sell.Price += item.CalculatePrice( stock + increaseStockBy );
+					quantityRemaining = quantityTaken - amountWanted;
+					quantityTaken = amountWanted;
 				}
 
-				sell.AddItem( canSell, quantityRemaining, quantityTaken, items[i] );
+				amountWanted -= quantityTaken;
 
-				if ( amountWanted <= 0 )
-					return true;
+				sell.Price += item.CalculatePriceRange( stock + increaseStockBy + 1, stock + increaseStockBy + quantityTaken );
+
+				increaseStockBy += quantityTaken;
 			}
+
+			sell.AddItem( canSell, quantityRemaining, quantityTaken, items[i] );
+
+			if ( amountWanted <= 0 )
+				return true;
 		}
 
 		return false;
@@ -335,8 +404,7 @@ class ExpansionMarketModule: JMModuleBase
 		Print("amountWanted " + amountWanted);
 		#endif
 
-		for ( int i = 0; i < amountWanted; i++ )
-			price += item.CalculatePrice( stock - i );
+		price = item.CalculatePriceRange( stock - amountWanted + 1, stock );
 
 		return true;
 	}
@@ -607,7 +675,7 @@ class ExpansionMarketModule: JMModuleBase
 	// ------------------------------------------------------------
 	// Expansion Bool FindMoneyAndCountTypes
 	// ------------------------------------------------------------
-	bool FindMoneyAndCountTypes( PlayerBase player, ExpansionMarketCurrency amount, out array< int > monies )
+	bool FindMoneyAndCountTypes( PlayerBase player, ExpansionMarketCurrency amount, out array< int > monies, ExpansionMarketPlayerInventory inventory = NULL )
 	{
 		if ( !monies )
 			monies = new array< int >;
@@ -615,29 +683,15 @@ class ExpansionMarketModule: JMModuleBase
 		if ( !player )
 			return false;
 
-		array< EntityAI > items = new array< EntityAI >;
-	   	player.GetInventory().EnumerateInventory( InventoryTraversalType.PREORDER, items );
+		if ( !inventory )
+			inventory = new ExpansionMarketPlayerInventory( player, this );
 
-		array< ref array< ExpansionMoneyBase > > foundMoney = new array< ref array< ExpansionMoneyBase > >;
+		array< ref array< ExpansionMoneyBase > > foundMoney = inventory.Money;
 		for ( int i = 0; i < m_MoneyDenominations.Count(); i++ )
 		{
-			foundMoney.Insert( new array< ExpansionMoneyBase > );
 			monies.Insert( 0 );
 		}
 
-		for ( i = 0; i < items.Count(); i++ )
-		{
-			ExpansionMoneyBase money;
-			if ( Class.CastTo( money, items[i] ) )
-			{
-				string type = money.GetType();
-				type.ToLower();
-
-				int idx = m_MoneyDenominations.Find( type );
-				foundMoney[ idx ].Insert( money );
-			}
-		}
-
 		ExpansionMarketCurrency foundAmount = 0;
 		ExpansionMarketCurrency minAmount = GetMoneyPrice( m_MoneyDenominations[ m_MoneyDenominations.Count() - 1 ] );
 
@@ -689,7 +743,7 @@ class ExpansionMarketModule: JMModuleBase
 	// ------------------------------------------------------------
 	// Expansion Float GetPlayerWorth
 	// ------------------------------------------------------------
-	ExpansionMarketCurrency GetPlayerWorth( PlayerBase player, out array< int > monies )
+	ExpansionMarketCurrency GetPlayerWorth( PlayerBase player, out array< int > monies, ExpansionMarketPlayerInventory inventory = NULL )
 	{
 		int i = 0;
 		ExpansionMarketCurrency worth = 0;
@@ -703,20 +757,21 @@ class ExpansionMarketModule: JMModuleBase
 		if ( !player )
 			return worth;
 
-		array< EntityAI > items = new array< EntityAI >;
-	   	player.GetInventory().EnumerateInventory( InventoryTraversalType.PREORDER, items );
+		if ( !inventory )
+			inventory = new ExpansionMarketPlayerInventory( player, this );
 
-		for ( i = 0; i < items.Count(); i++ )
+		for ( i = 0; i < inventory.Money.Count(); i++ )
 		{
-			ExpansionMoneyBase money;
-			if ( Class.CastTo( money, items[i] ) )
+			ExpansionMarketCurrency denomPrice = GetMoneyPrice( m_MoneyDenominations[i] );
+
+			array< ExpansionMoneyBase > denomMoney = inventory.Money[i];
+			for ( int j = 0; j < denomMoney.Count(); j++ )
 			{
-				string type = money.GetType();
-				type.ToLower();
-				int idx = m_MoneyDenominations.Find( type );
-				monies[ idx ] = monies[ idx ] + money.GetQuantity();
+				int quantity = denomMoney[j].GetQuantity();
+
+				monies[i] = monies[i] + quantity;
 
-				worth += GetMoneyPrice( type ) * money.GetQuantity();
+				worth += denomPrice * quantity;
 			}
 		}
 
@@ -728,7 +783,7 @@ class ExpansionMarketModule: JMModuleBase
 	// ------------------------------------------------------------
 	// will handle reserving partial of the stack for 1 transaction. to reserve the same stack for 
 	// another transaction the previous one must be cancelled.
-	bool FindMoneyAndReserve( PlayerBase player, ExpansionMarketCurrency amount, out array< ExpansionMoneyBase > monies )
+	bool FindMoneyAndReserve( PlayerBase player, ExpansionMarketCurrency amount, out array< ExpansionMoneyBase > monies, ExpansionMarketPlayerInventory inventory = NULL )
 	{
 		if ( !monies )
 			monies = new array< ExpansionMoneyBase >;
@@ -736,27 +791,11 @@ class ExpansionMarketModule: JMModuleBase
 		if ( !player )
 			return false;
 
-		array< EntityAI > items = new array< EntityAI >;
-	   	player.GetInventory().EnumerateInventory( InventoryTraversalType.PREORDER, items );
+		if ( !inventory )
+			inventory = new ExpansionMarketPlayerInventory( player, this );
 
-		array< ref array< ExpansionMoneyBase > > foundMoney = new array< ref array< ExpansionMoneyBase > >;
-		for ( int i = 0; i < m_MoneyDenominations.Count(); i++ )
-		{
-			foundMoney.Insert( new array< ExpansionMoneyBase > );
-		}
-
-		for ( i = 0; i < items.Count(); i++ )
-		{
-			ExpansionMoneyBase money;
-			if ( Class.CastTo( money, items[i] ) )
-			{
-				string type = money.GetType();
-				type.ToLower();
-
-				int idx = m_MoneyDenominations.Find( type );
-				foundMoney[idx].Insert( money );
-			}
-		}
+		array< ref array< ExpansionMoneyBase > > foundMoney = inventory.Money;
+		int i;
 
 		ExpansionMarketCurrency foundAmount = 0;
 		ExpansionMarketCurrency minAmount = GetMoneyPrice( m_MoneyDenominations[ m_MoneyDenominations.Count() - 1 ] );
@@ -870,21 +909,21 @@ class ExpansionMarketModule: JMModuleBase
 	// ------------------------------------------------------------
 	// Expansion UnlockMoney
 	// ------------------------------------------------------------
-	void UnlockMoney( PlayerBase player )
+	void UnlockMoney( PlayerBase player, ExpansionMarketPlayerInventory inventory = NULL )
 	{
 		if ( !player )
 			return;
 
-		array< EntityAI > items = new array< EntityAI >;
-	   	player.GetInventory().EnumerateInventory( InventoryTraversalType.PREORDER, items );
+		if ( !inventory )
+			inventory = new ExpansionMarketPlayerInventory( player, this );
 
-		for ( int i = 0; i < items.Count(); i++ )
+		for ( int i = 0; i < inventory.Money.Count(); i++ )
 		{
-			ExpansionMoneyBase money;
-			if ( Class.CastTo( money, items[i] ) )
+			array< ExpansionMoneyBase > denomMoney = inventory.Money[i];
+			for ( int j = 0; j < denomMoney.Count(); j++ )
 			{
-				money.ReservedAmount = 0;
-				money.IsReserved = false;
+				denomMoney[j].ReservedAmount = 0;
+				denomMoney[j].IsReserved = false;
 			}
 		}
 	}
@@ -995,6 +1034,16 @@ class ExpansionMarketModule: JMModuleBase
 				RPC_LoadItemData( ctx, sender, target );
 				break;
 			}
+			case ExpansionMarketModuleRPC.LoadTraderStock:
+			{
+				RPC_LoadTraderStock( ctx, sender, target );
+				break;
+			}
+			case ExpansionMarketModuleRPC.ExitTrader:
+			{
+				RPC_ExitTrader( ctx, sender, target );
+				break;
+			}
 		}
 	}
 
@@ -1155,6 +1204,17 @@ class ExpansionMarketModule: JMModuleBase
 	{
 		SendMoneyDenominations( identity );
 	}
+
+	// -----------------------------------------------------------
+	// Expansion OnInvokeDisconnect
+	// -----------------------------------------------------------
+	override void OnInvokeDisconnect( PlayerBase player )
+	{
+		if ( !player )
+			return;
+
+		m_TraderViewers.Remove( player.GetIdentityUID() );
+	}
 	
 	// -----------------------------------------------------------
 	// Expansion SendMoneyDenominations
@@ -1335,10 +1395,12 @@ class ExpansionMarketModule: JMModuleBase
 		
 		//! Find the money that will be reserved (always of type ExpansionMoneyBase), change the IsReserved to true.
 		//! Ignore the money that already has IsReserved as true.
-		UnlockMoney( player );
+		ExpansionMarketPlayerInventory inventory = new ExpansionMarketPlayerInventory( player, this );
+
+		UnlockMoney( player, inventory );
 
 		array< ExpansionMoneyBase > monies = new array< ExpansionMoneyBase >;
-		if ( !FindMoneyAndReserve( player, /*reservedList.Price*/currentPrice, monies ) )
+		if ( !FindMoneyAndReserve( player, /*reservedList.Price*/currentPrice, monies, inventory ) )
 		{
 			reservedList.ClearReserved( zone );
 			player.ClearMarketReserve();
@@ -1480,11 +1542,14 @@ class ExpansionMarketModule: JMModuleBase
 		reserve.SpawnObjects( zone, this, player );
 
 		Callback_Success( itemClassName, player.GetIdentity() );
+
+		//! Price of the item alone, reserve.Price includes the attachments
+		GetExpansionLogger().Event( new ExpansionMarketEventRecord( ExpansionMarketEventRecord.PURCHASE, player.GetIdentityUID(), reserve.Reserved[0].ClassName, reserve.Reserved[0].Amount, reserve.Reserved[0].Price, zone.m_ZoneName ) );
 		
 		//Need to clear reserved after a bought
 		reserve.ClearReserved( zone );
 
-		zone.Save();
+		SendTraderStockUpdates( zone );
 	}
 	
 	// ------------------------------------------------------------
@@ -1623,7 +1688,7 @@ class ExpansionMarketModule: JMModuleBase
 
 		// Compare that price to the one the player sent
 		// Look up into Exec_RequestBuy
-		if ( !FindSellPrice( player, sellList.Item, zone.GetStock( itemClassName ), count, sellList ) /*|| sellList.Price != currentPrice*/ )
+		if ( !FindSellPrice( player, sellList.Item, zone.GetStock( sellList.Item.ClassName ), count, sellList ) /*|| sellList.Price != currentPrice*/ )
 		{
 			sellList.Debug();
 
@@ -1637,8 +1702,6 @@ class ExpansionMarketModule: JMModuleBase
 		sellList.Time = GetGame().GetTime();
 
 		Callback_Success( itemClassName, player.GetIdentity() );
-
-		zone.Save();
 	}
 	
 	// ------------------------------------------------------------
@@ -1720,6 +1783,10 @@ class ExpansionMarketModule: JMModuleBase
 		SpawnMoney( player, sell.Price );
 		
 		zone.AddStock( itemClassName, sell.TotalAmount );
+
+		GetExpansionLogger().Event( new ExpansionMarketEventRecord( ExpansionMarketEventRecord.SELL, player.GetIdentityUID(), itemClassName, sell.TotalAmount, sell.Price, zone.m_ZoneName ) );
+
+		SendTraderStockUpdates( zone );
 	}
 	
 	// ------------------------------------------------------------
@@ -1815,22 +1882,43 @@ class ExpansionMarketModule: JMModuleBase
 
 	// ------------------------------------------------------------
 	// Expansion LoadTraderData
+	// Players who already hold a snapshot of this trader only get
+	// the stock that changed since, everybody else the full list
 	// ------------------------------------------------------------
 	void LoadTraderData( ExpansionTraderBase trader, PlayerIdentity ident )
 	{
-		m_NetworkItems.Clear();
-		trader.GetNetworkSerialization( m_NetworkItems );
+		ExpansionMarketTraderViewer viewer;
 
 		if ( IsMissionOffline() )
 		{
+			m_NetworkItems.Clear();
+			trader.GetNetworkSerialization( m_NetworkItems );
+
+			viewer = GetTraderViewer( ident );
+			viewer.Trader = trader;
+			viewer.IsOpen = true;
+
 			Exec_LoadTraderData( trader, ident );
 
 			SetTrader( trader );
 		} else if ( IsMissionHost() )
 		{
+			viewer = GetTraderViewer( ident );
+			viewer.IsOpen = true;
+
+			if ( viewer.Trader == trader && SendTraderStockDelta( viewer, true ) )
+				return;
+
+			m_NetworkItems.Clear();
+			trader.GetNetworkSerialization( m_NetworkItems );
+
 			ScriptRPC rpc = new ScriptRPC();
 			rpc.Write( m_NetworkItems );
 			rpc.Send( trader, ExpansionMarketModuleRPC.LoadTraderData, true, ident );
+
+			viewer.Trader = trader;
+			if ( trader.GetTraderZone() )
+				viewer.Version = trader.GetTraderZone().GetStockVersion();
 		}
 	}
 
@@ -1866,6 +1954,160 @@ class ExpansionMarketModule: JMModuleBase
 		Exec_LoadTraderData( trader, senderRPC );
 	}
 
+	// ------------------------------------------------------------
+	// Expansion GetTraderViewer
+	// ------------------------------------------------------------
+	protected ExpansionMarketTraderViewer GetTraderViewer( PlayerIdentity ident )
+	{
+		string id;
+		if ( ident )
+			id = ident.GetId();
+
+		ExpansionMarketTraderViewer viewer;
+		if ( !m_TraderViewers.Find( id, viewer ) )
+		{
+			viewer = new ExpansionMarketTraderViewer( ident );
+			m_TraderViewers.Insert( id, viewer );
+		}
+
+		return viewer;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion SendTraderStockDelta
+	// Sends the stock changed since the viewer's snapshot.
+	// Returns false if a full snapshot has to be sent instead.
+	// ------------------------------------------------------------
+	protected bool SendTraderStockDelta( ExpansionMarketTraderViewer viewer, bool sendEmpty )
+	{
+		if ( !viewer.Trader )
+			return false;
+
+		ExpansionMarketTraderZone zone = viewer.Trader.GetTraderZone();
+		if ( !zone )
+			return false;
+
+		TStringArray classNames = new TStringArray;
+		array< int > stocks = new array< int >;
+		if ( !zone.GetNetworkStockDelta( viewer.Trader.GetTraderMarket(), viewer.Version, classNames, stocks ) )
+			return false;
+
+		viewer.Version = zone.GetStockVersion();
+
+		if ( classNames.Count() == 0 && !sendEmpty )
+			return true;
+
+		ScriptRPC rpc = new ScriptRPC();
+		rpc.Write( classNames );
+		rpc.Write( stocks );
+		rpc.Send( viewer.Trader, ExpansionMarketModuleRPC.LoadTraderStock, true, viewer.Identity );
+
+		return true;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion SendTraderStockUpdates
+	// Pushes the stock changes of the zone to every player who
+	// currently has one of its traders open
+	// ------------------------------------------------------------
+	protected void SendTraderStockUpdates( ExpansionMarketTraderZone zone )
+	{
+		for ( int i = m_TraderViewers.Count() - 1; i >= 0; i-- )
+		{
+			ExpansionMarketTraderViewer viewer = m_TraderViewers.GetElement( i );
+			if ( !viewer.IsOpen || !viewer.Trader || viewer.Trader.GetTraderZone() != zone )
+				continue;
+
+			if ( IsMissionOffline() )
+			{
+				LoadTraderData( viewer.Trader, NULL );
+				continue;
+			}
+
+			if ( !viewer.Identity )
+			{
+				m_TraderViewers.RemoveElement( i );
+				continue;
+			}
+
+			//! Journal no longer covers the snapshot, resend everything
+			if ( !SendTraderStockDelta( viewer, false ) )
+				LoadTraderData( viewer.Trader, viewer.Identity );
+		}
+	}
+
+	// ------------------------------------------------------------
+	// Expansion Exec_LoadTraderStock
+	// ------------------------------------------------------------
+	private void Exec_LoadTraderStock( ExpansionTraderBase trader, TStringArray classNames, array< int > stocks )
+	{
+		for ( int i = 0; i < classNames.Count(); i++ )
+		{
+			m_ClientMarketZone.SetStock( classNames[i], stocks[i] );
+		}
+
+		SetTrader( trader );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion RPC_LoadTraderStock
+	// ------------------------------------------------------------
+	private void RPC_LoadTraderStock( ref ParamsReadContext ctx, PlayerIdentity senderRPC, Object target )
+	{
+		ExpansionTraderBase trader;
+		if ( !Class.CastTo( trader, target ) )
+			return;
+
+		TStringArray classNames;
+		if ( !ctx.Read( classNames ) )
+			return;
+
+		array< int > stocks;
+		if ( !ctx.Read( stocks ) || stocks.Count() != classNames.Count() )
+			return;
+
+		Exec_LoadTraderStock( trader, classNames, stocks );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion ExitTrader
+	// Tells the server the market menu was closed so it stops
+	// pushing stock changes of that trader
+	// ------------------------------------------------------------
+	void ExitTrader( ExpansionTraderBase trader )
+	{
+		if ( IsMissionOffline() )
+		{
+			Exec_ExitTrader( NULL );
+		} else if ( !IsMissionHost() )
+		{
+			ScriptRPC rpc = new ScriptRPC();
+			rpc.Send( trader, ExpansionMarketModuleRPC.ExitTrader, true, NULL );
+		}
+	}
+
+	// ------------------------------------------------------------
+	// Expansion Exec_ExitTrader
+	// ------------------------------------------------------------
+	private void Exec_ExitTrader( PlayerIdentity ident )
+	{
+		string id;
+		if ( ident )
+			id = ident.GetId();
+
+		ExpansionMarketTraderViewer viewer;
+		if ( m_TraderViewers.Find( id, viewer ) )
+			viewer.IsOpen = false;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion RPC_ExitTrader
+	// ------------------------------------------------------------
+	private void RPC_ExitTrader( ref ParamsReadContext ctx, PlayerIdentity senderRPC, Object target )
+	{
+		Exec_ExitTrader( senderRPC );
+	}
+
 	// ------------------------------------------------------------
 	// Expansion RequestItemData
 	// ------------------------------------------------------------
@@ -0,0 +1,84 @@
+/**
+ * ExpansionMarketPlayerInventory.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2020 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionMarketPlayerInventory
+ * @brief		Snapshot of a player inventory, enumerated once per market transaction.
+ *				Money is bucketed by denomination index, every item by lowercase class name.
+ **/
+class ExpansionMarketPlayerInventory
+{
+	PlayerBase Player;
+
+	//! Indexed like ExpansionMarketModule::m_MoneyDenominations
+	ref array< ref array< ExpansionMoneyBase > > Money;
+
+	ref map< string, ref array< EntityAI > > Items;
+
+	// ------------------------------------------------------------
+	// ExpansionMarketPlayerInventory Constructor
+	// ------------------------------------------------------------
+	void ExpansionMarketPlayerInventory( PlayerBase player, ExpansionMarketModule module )
+	{
+		Player = player;
+
+		Money = new array< ref array< ExpansionMoneyBase > >;
+		Items = new map< string, ref array< EntityAI > >;
+
+		int denominations = module.GetMoneyDenominationCount();
+		for ( int i = 0; i < denominations; i++ )
+		{
+			Money.Insert( new array< ExpansionMoneyBase > );
+		}
+
+		if ( !player )
+			return;
+
+		array< EntityAI > items = new array< EntityAI >;
+		player.GetInventory().EnumerateInventory( InventoryTraversalType.PREORDER, items );
+
+		for ( i = 0; i < items.Count(); i++ )
+		{
+			EntityAI item = items[i];
+			if ( !item )
+				continue;
+
+			string type = item.GetType();
+			type.ToLower();
+
+			array< EntityAI > typeItems;
+			if ( !Items.Find( type, typeItems ) )
+			{
+				typeItems = new array< EntityAI >;
+				Items.Insert( type, typeItems );
+			}
+
+			typeItems.Insert( item );
+
+			ExpansionMoneyBase money;
+			if ( Class.CastTo( money, item ) )
+			{
+				int idx = module.GetMoneyDenominationIndex( type );
+				if ( idx > -1 )
+					Money[idx].Insert( money );
+			}
+		}
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetItems
+	// Returns the items of that lowercase class name, or NULL
+	// ------------------------------------------------------------
+	array< EntityAI > GetItems( string className )
+	{
+		return Items.Get( className );
+	}
+}
@@ -0,0 +1,33 @@
+/**
+ * ExpansionMarketTraderViewer.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2020 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionMarketTraderViewer
+ * @brief		Server side record of the last trader stock snapshot sent to a player
+ **/
+class ExpansionMarketTraderViewer
+{
+	PlayerIdentity Identity;
+
+	//! Trader the player holds a snapshot of
+	ExpansionTraderBase Trader;
+
+	//! Stock version of the trader zone the snapshot is up to date with
+	int Version;
+
+	//! True while the player has the market menu of that trader open
+	bool IsOpen;
+
+	void ExpansionMarketTraderViewer( PlayerIdentity identity )
+	{
+		Identity = identity;
+	}
+}
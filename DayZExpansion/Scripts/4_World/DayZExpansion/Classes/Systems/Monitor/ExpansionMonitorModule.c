@@ -15,10 +15,17 @@
  **/
 
 class ExpansionMonitorModule: JMModuleBase
-{	
+{
+	//! Every subscribed player gets refreshed once per STATS_SYNC_INTERVAL seconds, spread over the updates in between
+	static const float STATS_SYNC_INTERVAL = 2.0;
+
 	//Server only
 	protected ref map< string, ref ExpansionSyncedPlayerStats > m_Stats;
+	//! Keys of m_Stats in the order the cursor walks them, the map itself gives no guarantee on order after a removal
+	protected ref TStringArray m_StatsOrder;
+	protected ref ExpansionSyncedPlayerStats m_CurrentStats;
 	protected float m_MonitorTimer;
+	protected int m_MonitorCursor;
 	
 	//Client only
 	protected ref ExpansionSyncedPlayerStats m_PlayerStats;
@@ -35,7 +42,10 @@ class ExpansionMonitorModule: JMModuleBase
 		if (IsMissionHost())
 		{
 			m_Stats = new map< string, ref ExpansionSyncedPlayerStats>;
+			m_StatsOrder = new TStringArray;
+			m_CurrentStats = new ExpansionSyncedPlayerStats;
 			m_MonitorTimer = 0;
+			m_MonitorCursor = 0;
 		}
 		else
 		{
@@ -65,7 +75,6 @@ class ExpansionMonitorModule: JMModuleBase
 	
 	// ------------------------------------------------------------
 	// Override OnRPC
-	// Called on client
 	// ------------------------------------------------------------
 	override void OnRPC( PlayerIdentity sender, Object target, int rpc_type, ref ParamsReadContext ctx )
 	{
@@ -77,34 +86,15 @@ class ExpansionMonitorModule: JMModuleBase
 		case ExpansionMonitorRPC.SyncStats:
 			RPC_SyncPlayerStats( ctx, sender, target );
 			break;
+		case ExpansionMonitorRPC.SubscribeStats:
+			RPC_SubscribeStats( ctx, sender, target );
+			break;
 		}
 
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("ExpansionMonitorModule::OnRPC - End");
 		#endif
 	}
-
-	// ------------------------------------------------------------
-	// Override OnInvokeConnect
-	// ------------------------------------------------------------
-	override void OnInvokeConnect( PlayerBase player, PlayerIdentity identity )
-	{
-		#ifdef EXPANSIONEXPRINT
-		EXPrint( "ExpansionPartyModule::OnInvokeConnect - Start" );
-		#endif
-
-		Print("ExpansionMonitorModule::OnInvokeConnect player : " + player);
-
-		if ( player )
-		{
-			AddPlayerStats( player, identity );
-			SyncStats( identity );
-		}
-
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionPartyModule::OnInvokeConnect - End");
-		#endif
-	}
 	
 	// ------------------------------------------------------------
 	// Override OnClientLogout
@@ -122,16 +112,33 @@ class ExpansionMonitorModule: JMModuleBase
 	{
 		super.OnUpdate( timeslice );
 
+		if ( !IsMissionHost() )
+			return;
+
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("ExpansionMonitorModule::OnUpdate - Start");
 		#endif
 
+		int count = m_StatsOrder.Count();
+		if ( count == 0 )
+		{
+			m_MonitorCursor = 0;
+			m_MonitorTimer = 0;
+			return;
+		}
+
 		m_MonitorTimer += timeslice;
-		//! Update and sync values every 5 seconds
-		if ( m_MonitorTimer >= 5.0 )
+
+		int due = Math.Ceil( count * Math.Min( m_MonitorTimer / STATS_SYNC_INTERVAL, 1 ) );
+
+		while ( m_MonitorCursor < due && m_MonitorCursor < count )
+		{
+			UpdatePlayerStats( m_Stats.Get( m_StatsOrder[m_MonitorCursor++] ) );
+		}
+
+		if ( m_MonitorTimer >= STATS_SYNC_INTERVAL )
 		{
-			UpdatePlayerStats();
-			
+			m_MonitorCursor = 0;
 			m_MonitorTimer = 0;
 		}
 
@@ -141,8 +148,8 @@ class ExpansionMonitorModule: JMModuleBase
 	}
 	
 	// ------------------------------------------------------------
-	// Override AddPlayerStats
-	// Called on server
+	// Expansion AddPlayerStats
+	// Called on server when a client opens the status tab
 	// ------------------------------------------------------------
 	void AddPlayerStats(PlayerBase player, PlayerIdentity identity)
 	{		
@@ -152,26 +159,20 @@ class ExpansionMonitorModule: JMModuleBase
 		EXPrint("ExpansionMonitorModule::AddPlayerStats - Start");
 		#endif
 		
-		ref ExpansionSyncedPlayerStats player_stats = new ExpansionSyncedPlayerStats;
-		
-		player_stats.m_PlayerUID = identity.GetId();
-		player_stats.m_Health = CalcHealth(player);
-		player_stats.m_Blood = CalcBlood(player);
-		player_stats.m_Water = CalcWater(player);
-		player_stats.m_Energy = CalcEnergy(player);
-		player_stats.m_Stamina = CalcStamina(player);
-		//! player_stats.m_Karma = player.GetKarma();
-		
-		player_stats.m_Distance = player.StatGet("dist");
-		player_stats.m_Playtime = player.StatGet("playtime");
-		player_stats.m_PlayersKilled = player.StatGet("players_killed");
-		player_stats.m_InfectedKilled = player.StatGet("infected_killed");
-		player_stats.m_AnimalsKilled = player.StatGet("animals_killed");
-		player_stats.m_LongestShot = player.StatGet("longest_survivor_hit");
-		
-		player_stats.m_Weight = CalcWeight(player);
-		
-		m_Stats.Insert(player_stats.m_PlayerUID, player_stats);
+		ref ExpansionSyncedPlayerStats player_stats = m_Stats.Get( identity.GetId() );
+		if ( !player_stats )
+		{
+			player_stats = new ExpansionSyncedPlayerStats;
+			player_stats.m_PlayerUID = identity.GetId();
+			m_Stats.Insert( player_stats.m_PlayerUID, player_stats );
+			m_StatsOrder.Insert( player_stats.m_PlayerUID );
+		}
+
+		CalcPlayerStats( player, m_CurrentStats );
+		player_stats.Apply( m_CurrentStats );
+
+		//! The client may have stale values from an earlier subscription, send everything once
+		SyncStats( identity, player_stats, ExpansionSyncedPlayerStatsField.ALL );
 
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("ExpansionMonitorModule::AddPlayerStats - End");
@@ -184,13 +185,22 @@ class ExpansionMonitorModule: JMModuleBase
 	// ------------------------------------------------------------
 	void RemovePlayerStats(PlayerIdentity identity)
 	{
-		if ( !IsMissionHost() ) return;
+		if ( !IsMissionHost() || !identity ) return;
 
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("ExpansionMonitorModule::RemovePlayerStats - Start");
 		#endif
 		
-		m_Stats.Remove(identity.GetId());
+		int index = m_StatsOrder.Find( identity.GetId() );
+		if ( index == -1 )
+			return;
+
+		//! Keep the cursor on the next player so nobody gets skipped in this pass
+		if ( index < m_MonitorCursor )
+			m_MonitorCursor--;
+
+		m_StatsOrder.RemoveOrdered( index );
+		m_Stats.Remove( identity.GetId() );
 
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("ExpansionMonitorModule::RemovePlayerStats - End");
@@ -199,77 +209,52 @@ class ExpansionMonitorModule: JMModuleBase
 	
 	// ------------------------------------------------------------
 	// Expansion UpdatePlayerStats
+	// Called on server, only sends the fields that changed since the last sync
 	// ------------------------------------------------------------
-	void UpdatePlayerStats()
+	protected void UpdatePlayerStats( ExpansionSyncedPlayerStats current_stats )
 	{
-		if ( !IsMissionHost() ) return;
+		PlayerBase active_player = PlayerBase.GetPlayerByUID( current_stats.m_PlayerUID );
+		
+		if ( !active_player || !active_player.GetIdentity() )
+			return;
+		
+		CalcPlayerStats( active_player, m_CurrentStats );
 
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionMonitorModule::UpdatePlayerStats - Start");
-		#endif
-			
-		for (int i = 0; i < m_Stats.Count(); ++i) 
-		{
-			ref ExpansionSyncedPlayerStats current_stats = m_Stats.GetElement(i);
-
-			PlayerBase active_player = PlayerBase.GetPlayerByUID( current_stats.m_PlayerUID );
-			
-			if ( !active_player || !active_player.GetIdentity() )
-				continue;
-			
-			current_stats.m_Health = CalcHealth(active_player);
-			current_stats.m_Blood = CalcBlood(active_player);
-			current_stats.m_Water = CalcWater(active_player);
-			current_stats.m_Energy = CalcEnergy(active_player);
-			current_stats.m_Stamina = CalcStamina(active_player);
-			//! current_stats.m_Karma = active_player.GetKarma();
-			
-			current_stats.m_Distance = active_player.StatGet("dist");
-			current_stats.m_Playtime = active_player.StatGet("playtime");
-			current_stats.m_PlayersKilled = active_player.StatGet("players_killed");
-			current_stats.m_InfectedKilled = active_player.StatGet("infected_killed");
-			current_stats.m_AnimalsKilled = active_player.StatGet("animals_killed");
-			current_stats.m_LongestShot = active_player.StatGet("longest_survivor_hit");
-			
-			current_stats.m_Weight = CalcWeight(active_player);
-			
-			SyncStats( active_player.GetIdentity(), current_stats );
-		}
+		int changed = current_stats.Apply( m_CurrentStats );
+		if ( changed == 0 )
+			return;
 
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionMonitorModule::UpdatePlayerStats - End");
-		#endif
+		SyncStats( active_player.GetIdentity(), current_stats, changed );
 	}
-		
+	
 	// ------------------------------------------------------------
-	// Expansion SyncStats
+	// Expansion CalcPlayerStats
 	// Called on server
 	// ------------------------------------------------------------
-	void SyncStats( PlayerIdentity identity )
+	protected void CalcPlayerStats( PlayerBase player, ExpansionSyncedPlayerStats stats )
 	{
-		ExpansionSyncedPlayerStats stats = m_Stats.Get( identity.GetId() );
-				
-		if ( !IsMissionHost() || !stats )
-			return;
-
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionMonitorModule::SyncStats - Start");
-		#endif
+		stats.m_Health = CalcHealth(player);
+		stats.m_Blood = CalcBlood(player);
+		stats.m_Water = CalcWater(player);
+		stats.m_Energy = CalcEnergy(player);
+		stats.m_Stamina = CalcStamina(player);
+		//! stats.m_Karma = player.GetKarma();
 		
-		ScriptRPC rpc = new ScriptRPC();
-		rpc.Write( stats );
-		rpc.Send( NULL, ExpansionMonitorRPC.SyncStats, false, identity );
-
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionMonitorModule::SyncStats - End");
-		#endif
+		stats.m_Distance = player.StatGet("dist");
+		stats.m_Playtime = player.StatGet("playtime");
+		stats.m_PlayersKilled = player.StatGet("players_killed");
+		stats.m_InfectedKilled = player.StatGet("infected_killed");
+		stats.m_AnimalsKilled = player.StatGet("animals_killed");
+		stats.m_LongestShot = player.StatGet("longest_survivor_hit");
+		
+		stats.m_Weight = CalcWeight(player);
 	}
 
 	// ------------------------------------------------------------
 	// Expansion SyncStats
 	// Called on server
 	// ------------------------------------------------------------
-	void SyncStats( PlayerIdentity identity, ref ExpansionSyncedPlayerStats stats )
+	void SyncStats( PlayerIdentity identity, ref ExpansionSyncedPlayerStats stats, int fields )
 	{		
 		if ( !IsMissionHost() || !stats )
 			return;
@@ -279,7 +264,7 @@ class ExpansionMonitorModule: JMModuleBase
 		#endif
 		
 		ScriptRPC rpc = new ScriptRPC();
-		rpc.Write( stats );
+		stats.OnSend( rpc, fields );
 		rpc.Send( NULL, ExpansionMonitorRPC.SyncStats, false, identity );
 
 		#ifdef EXPANSIONEXPRINT
@@ -293,8 +278,64 @@ class ExpansionMonitorModule: JMModuleBase
 	// ------------------------------------------------------------
 	private void RPC_SyncPlayerStats( ref ParamsReadContext ctx, PlayerIdentity senderRPC, Object target )
 	{
-		if ( !ctx.Read( m_PlayerStats ) )
+		if ( !m_PlayerStats )
+			m_PlayerStats = new ExpansionSyncedPlayerStats;
+
+		m_PlayerStats.OnReceive( ctx );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion SubscribeStats
+	// Called on client, stats are only synced while the status tab is open
+	// ------------------------------------------------------------
+	void SubscribeStats( bool subscribe )
+	{
+		if ( IsMissionOffline() )
+		{
+			PlayerBase player = PlayerBase.Cast( GetGame().GetPlayer() );
+			if ( !player )
+				return;
+
+			if ( !m_PlayerStats )
+				m_PlayerStats = new ExpansionSyncedPlayerStats;
+
+			//! No network in offline mode, calculate the values directly when the tab opens
+			CalcPlayerStats( player, m_PlayerStats );
+			return;
+		}
+
+		if ( !IsMissionClient() )
+			return;
+
+		ScriptRPC rpc = new ScriptRPC();
+		rpc.Write( subscribe );
+		rpc.Send( NULL, ExpansionMonitorRPC.SubscribeStats, true, NULL );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion RPC_SubscribeStats
+	// Called on server
+	// ------------------------------------------------------------
+	private void RPC_SubscribeStats( ref ParamsReadContext ctx, PlayerIdentity senderRPC, Object target )
+	{
+		if ( !IsMissionHost() || !senderRPC )
+			return;
+
+		bool subscribe;
+		if ( !ctx.Read( subscribe ) )
+			return;
+
+		if ( !subscribe )
+		{
+			RemovePlayerStats( senderRPC );
+			return;
+		}
+
+		PlayerBase player = PlayerBase.GetPlayerByUID( senderRPC.GetId() );
+		if ( !player )
 			return;
+
+		AddPlayerStats( player, senderRPC );
 	}
 	
 	// ------------------------------------------------------------
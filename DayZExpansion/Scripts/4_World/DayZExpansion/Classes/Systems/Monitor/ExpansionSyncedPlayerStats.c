@@ -10,6 +10,24 @@
  *
 */
 
+enum ExpansionSyncedPlayerStatsField
+{
+	HEALTH			= 1,
+	BLOOD			= 2,
+	WATER			= 4,
+	ENERGY			= 8,
+	STAMINA			= 16,
+	DISTANCE		= 32,
+	PLAYTIME		= 64,
+	PLAYERS_KILLED	= 128,
+	INFECTED_KILLED	= 256,
+	ANIMALS_KILLED	= 512,
+	LONGEST_SHOT	= 1024,
+	WEIGHT			= 2048,
+
+	ALL				= 4095
+}
+
 /**@class		ExpansionSyncedPlayerStats
  * @brief		This class handles the sycronised player stats values
  **/
@@ -33,4 +51,125 @@ class ExpansionSyncedPlayerStats
 	float m_LongestShot;
 	
 	int m_Weight;
+
+	// ------------------------------------------------------------
+	// ExpansionSyncedPlayerStats Apply
+	// Copies the values of stats and returns the fields that changed
+	// ------------------------------------------------------------
+	int Apply( ExpansionSyncedPlayerStats stats )
+	{
+		int changed = 0;
+
+		if ( m_Health != stats.m_Health )
+			changed |= ExpansionSyncedPlayerStatsField.HEALTH;
+		if ( m_Blood != stats.m_Blood )
+			changed |= ExpansionSyncedPlayerStatsField.BLOOD;
+		if ( m_Water != stats.m_Water )
+			changed |= ExpansionSyncedPlayerStatsField.WATER;
+		if ( m_Energy != stats.m_Energy )
+			changed |= ExpansionSyncedPlayerStatsField.ENERGY;
+		if ( m_Stamina != stats.m_Stamina )
+			changed |= ExpansionSyncedPlayerStatsField.STAMINA;
+		if ( m_Distance != stats.m_Distance )
+			changed |= ExpansionSyncedPlayerStatsField.DISTANCE;
+		if ( m_Playtime != stats.m_Playtime )
+			changed |= ExpansionSyncedPlayerStatsField.PLAYTIME;
+		if ( m_PlayersKilled != stats.m_PlayersKilled )
+			changed |= ExpansionSyncedPlayerStatsField.PLAYERS_KILLED;
+		if ( m_InfectedKilled != stats.m_InfectedKilled )
+			changed |= ExpansionSyncedPlayerStatsField.INFECTED_KILLED;
+		if ( m_AnimalsKilled != stats.m_AnimalsKilled )
+			changed |= ExpansionSyncedPlayerStatsField.ANIMALS_KILLED;
+		if ( m_LongestShot != stats.m_LongestShot )
+			changed |= ExpansionSyncedPlayerStatsField.LONGEST_SHOT;
+		if ( m_Weight != stats.m_Weight )
+			changed |= ExpansionSyncedPlayerStatsField.WEIGHT;
+
+		m_Health = stats.m_Health;
+		m_Blood = stats.m_Blood;
+		m_Water = stats.m_Water;
+		m_Energy = stats.m_Energy;
+		m_Stamina = stats.m_Stamina;
+		m_Distance = stats.m_Distance;
+		m_Playtime = stats.m_Playtime;
+		m_PlayersKilled = stats.m_PlayersKilled;
+		m_InfectedKilled = stats.m_InfectedKilled;
+		m_AnimalsKilled = stats.m_AnimalsKilled;
+		m_LongestShot = stats.m_LongestShot;
+		m_Weight = stats.m_Weight;
+
+		return changed;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionSyncedPlayerStats OnSend
+	// Writes the mask followed by the fields it contains
+	// ------------------------------------------------------------
+	void OnSend( ParamsWriteContext ctx, int fields )
+	{
+		ctx.Write( fields );
+
+		if ( fields & ExpansionSyncedPlayerStatsField.HEALTH )
+			ctx.Write( m_Health );
+		if ( fields & ExpansionSyncedPlayerStatsField.BLOOD )
+			ctx.Write( m_Blood );
+		if ( fields & ExpansionSyncedPlayerStatsField.WATER )
+			ctx.Write( m_Water );
+		if ( fields & ExpansionSyncedPlayerStatsField.ENERGY )
+			ctx.Write( m_Energy );
+		if ( fields & ExpansionSyncedPlayerStatsField.STAMINA )
+			ctx.Write( m_Stamina );
+		if ( fields & ExpansionSyncedPlayerStatsField.DISTANCE )
+			ctx.Write( m_Distance );
+		if ( fields & ExpansionSyncedPlayerStatsField.PLAYTIME )
+			ctx.Write( m_Playtime );
+		if ( fields & ExpansionSyncedPlayerStatsField.PLAYERS_KILLED )
+			ctx.Write( m_PlayersKilled );
+		if ( fields & ExpansionSyncedPlayerStatsField.INFECTED_KILLED )
+			ctx.Write( m_InfectedKilled );
+		if ( fields & ExpansionSyncedPlayerStatsField.ANIMALS_KILLED )
+			ctx.Write( m_AnimalsKilled );
+		if ( fields & ExpansionSyncedPlayerStatsField.LONGEST_SHOT )
+			ctx.Write( m_LongestShot );
+		if ( fields & ExpansionSyncedPlayerStatsField.WEIGHT )
+			ctx.Write( m_Weight );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionSyncedPlayerStats OnReceive
+	// Reads a mask written by OnSend, fields not in the mask keep their value
+	// ------------------------------------------------------------
+	bool OnReceive( ParamsReadContext ctx )
+	{
+		int fields;
+		if ( !ctx.Read( fields ) )
+			return false;
+
+		if ( ( fields & ExpansionSyncedPlayerStatsField.HEALTH ) && !ctx.Read( m_Health ) )
+			return false;
+		if ( ( fields & ExpansionSyncedPlayerStatsField.BLOOD ) && !ctx.Read( m_Blood ) )
+			return false;
+		if ( ( fields & ExpansionSyncedPlayerStatsField.WATER ) && !ctx.Read( m_Water ) )
+			return false;
+		if ( ( fields & ExpansionSyncedPlayerStatsField.ENERGY ) && !ctx.Read( m_Energy ) )
+			return false;
+		if ( ( fields & ExpansionSyncedPlayerStatsField.STAMINA ) && !ctx.Read( m_Stamina ) )
+			return false;
+		if ( ( fields & ExpansionSyncedPlayerStatsField.DISTANCE ) && !ctx.Read( m_Distance ) )
+			return false;
+		if ( ( fields & ExpansionSyncedPlayerStatsField.PLAYTIME ) && !ctx.Read( m_Playtime ) )
+			return false;
+		if ( ( fields & ExpansionSyncedPlayerStatsField.PLAYERS_KILLED ) && !ctx.Read( m_PlayersKilled ) )
+			return false;
+		if ( ( fields & ExpansionSyncedPlayerStatsField.INFECTED_KILLED ) && !ctx.Read( m_InfectedKilled ) )
+			return false;
+		if ( ( fields & ExpansionSyncedPlayerStatsField.ANIMALS_KILLED ) && !ctx.Read( m_AnimalsKilled ) )
+			return false;
+		if ( ( fields & ExpansionSyncedPlayerStatsField.LONGEST_SHOT ) && !ctx.Read( m_LongestShot ) )
+			return false;
+		if ( ( fields & ExpansionSyncedPlayerStatsField.WEIGHT ) && !ctx.Read( m_Weight ) )
+			return false;
+
+		return true;
+	}
 }
\ No newline at end of file
@@ -10,11 +10,28 @@
  *
 */
 
+class ExpansionNotificationBatch
+{
+	ref ScriptRPC RPC;
+	//! NULL for a broadcast to every player
+	ref array< PlayerIdentity > Recipients;
+
+	void ExpansionNotificationBatch( ScriptRPC rpc, array< PlayerIdentity > recipients )
+	{
+		RPC = rpc;
+		Recipients = recipients;
+	}
+}
+
 /**@class		ExpansionNotificationModule
- * @brief		This class handle notification toasts system
+ * @brief		This class handle notification toasts system.
+ *				On server, notifications for several players are serialized once
+ *				and sent to all of them on the next update.
  **/
 class ExpansionNotificationModule: JMModuleBase
 {
+	protected ref array< ref ExpansionNotificationBatch > m_PendingBatches;
+
 	protected ref array< ref ExpansionNotificationUI > m_Notifications;
 	protected ref array< ref NotificationRuntimeData > m_NotificationData;
 	protected ref ExpansionNotificationUIGrid m_NotificationUIGrid;
@@ -26,6 +43,8 @@ class ExpansionNotificationModule: JMModuleBase
 		EXPrint("ExpansionNotificationModule::ExpansionNotificationModule - Start");
 		#endif
 		
+		m_PendingBatches = new array< ref ExpansionNotificationBatch >;
+
 		m_Notifications = new array< ref ExpansionNotificationUI >;
 		m_NotificationData = new array< ref NotificationRuntimeData >;
 
@@ -85,6 +104,147 @@ class ExpansionNotificationModule: JMModuleBase
 		#endif
 	}*/
 
+	// ------------------------------------------------------------
+	// Expansion Notify
+	// Serializes the notification once, it's sent to the recipients on the next update
+	// ------------------------------------------------------------
+	void Notify( StringLocaliser title, StringLocaliser text, string icon, int color, float time, array< PlayerIdentity > recipients )
+	{
+		if ( !IsMissionHost() )
+		{
+			NotificationSystem.Create_Expansion( title, text, icon, color, time, NULL );
+			return;
+		}
+
+		if ( !recipients || recipients.Count() == 0 )
+			return;
+
+		#ifdef EXPANSIONEXLOGPRINT
+		EXLogPrint( "ExpansionNotificationModule::Notify " + title.Format() + ": " + text.Format() + " recipients : " + recipients.Count() );
+		#endif
+
+		m_PendingBatches.Insert( new ExpansionNotificationBatch( NotificationSystem.Expansion_CreateRPC( title, text, icon, color, time ), recipients ) );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion NotifyAll
+	// Queued like the others, flushed as a single broadcast
+	// ------------------------------------------------------------
+	void NotifyAll( StringLocaliser title, StringLocaliser text, string icon, int color, float time )
+	{
+		if ( !IsMissionHost() )
+		{
+			NotificationSystem.Create_Expansion( title, text, icon, color, time, NULL );
+			return;
+		}
+
+		#ifdef EXPANSIONEXLOGPRINT
+		EXLogPrint( "ExpansionNotificationModule::NotifyAll " + title.Format() + ": " + text.Format() );
+		#endif
+
+		m_PendingBatches.Insert( new ExpansionNotificationBatch( NotificationSystem.Expansion_CreateRPC( title, text, icon, color, time ), NULL ) );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion NotifyParty
+	// Online members of the party, except the one with excludeUID
+	// ------------------------------------------------------------
+	void NotifyParty( StringLocaliser title, StringLocaliser text, string icon, int color, float time, ExpansionPartySaveFormat party, string excludeUID = "" )
+	{
+		array< ref ExpansionPartySaveFormatPlayer > players = party.GetPlayers();
+		if ( !players )
+			return;
+
+		array< PlayerIdentity > recipients = new array< PlayerIdentity >;
+
+		for ( int i = 0; i < players.Count(); i++ )
+		{
+			if ( players[i] && players[i].UID != excludeUID )
+				AddRecipient( recipients, players[i].UID );
+		}
+
+		Notify( title, text, icon, color, time, recipients );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion NotifyTerritory
+	// Online members of the territory, except the one with excludeUID
+	// ------------------------------------------------------------
+	void NotifyTerritory( StringLocaliser title, StringLocaliser text, string icon, int color, float time, ExpansionTerritory territory, string excludeUID = "" )
+	{
+		array< ref ExpansionTerritoryMember > members = territory.GetTerritoryMembers();
+		if ( !members )
+			return;
+
+		array< PlayerIdentity > recipients = new array< PlayerIdentity >;
+
+		for ( int i = 0; i < members.Count(); i++ )
+		{
+			if ( members[i] && members[i].GetID() != excludeUID )
+				AddRecipient( recipients, members[i].GetID() );
+		}
+
+		Notify( title, text, icon, color, time, recipients );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion NotifyRadius
+	// Players within radius meters of position
+	// ------------------------------------------------------------
+	void NotifyRadius( StringLocaliser title, StringLocaliser text, string icon, int color, float time, vector position, float radius )
+	{
+		array< PlayerIdentity > recipients = new array< PlayerIdentity >;
+
+		float radiusSq = radius * radius;
+
+		array< PlayerBase > players = PlayerBase.GetAll();
+		for ( int i = 0; i < players.Count(); i++ )
+		{
+			PlayerBase player = players[i];
+			if ( player && player.GetIdentity() && vector.DistanceSq( player.GetPosition(), position ) <= radiusSq )
+				recipients.Insert( player.GetIdentity() );
+		}
+
+		Notify( title, text, icon, color, time, recipients );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion AddRecipient
+	// ------------------------------------------------------------
+	protected void AddRecipient( array< PlayerIdentity > recipients, string uid )
+	{
+		PlayerBase player = PlayerBase.GetPlayerByUID( uid );
+		if ( player && player.GetIdentity() )
+			recipients.Insert( player.GetIdentity() );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion FlushNotifications
+	// ------------------------------------------------------------
+	protected void FlushNotifications()
+	{
+		for ( int i = 0; i < m_PendingBatches.Count(); i++ )
+		{
+			ExpansionNotificationBatch batch = m_PendingBatches[i];
+
+			//! NotifyAll, one broadcast instead of a send per player
+			if ( !batch.Recipients )
+			{
+				batch.RPC.Send( NULL, NotificationSystemRPC.Create, true, NULL );
+				continue;
+			}
+
+			for ( int j = 0; j < batch.Recipients.Count(); j++ )
+			{
+				//! The player may have disconnected since the notification was queued
+				if ( batch.Recipients[j] )
+					batch.RPC.Send( NULL, NotificationSystemRPC.Create, true, batch.Recipients[j] );
+			}
+		}
+
+		m_PendingBatches.Clear();
+	}
+
 	// ------------------------------------------------------------
 	int GetNotificationsCount()
 	{
@@ -229,6 +389,11 @@ class ExpansionNotificationModule: JMModuleBase
 		
 		super.OnUpdate( timeslice );
 
+		if ( m_PendingBatches.Count() > 0 )
+		{
+			FlushNotifications();
+		}
+
 		if ( IsMissionClient() )
 		{
 			for ( int i = 0; i < m_Notifications.Count(); i++ )
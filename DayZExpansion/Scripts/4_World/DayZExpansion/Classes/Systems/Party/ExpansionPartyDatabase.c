@@ -0,0 +1,149 @@
+/**
+ * ExpansionPartyDatabase.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2020 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionPartyDatabase
+ * @brief		Single file holding every party, used when parties are saved as binary
+ *
+ * Layout: version, party count, the ID of every party, then one record per party
+ * in the same order. Markers are not part of the database, each party keeps them
+ * in its own file which is only read once the party is needed.
+ **/
+class ExpansionPartyDatabase
+{
+	static const int VERSION = 1;
+
+	// ------------------------------------------------------------
+	// ExpansionPartyDatabase Load
+	// Reads all parties in one pass, returns false if the file is missing or invalid
+	// ------------------------------------------------------------
+	static bool Load( string path, notnull map< int, ref ExpansionPartySaveFormat > parties )
+	{
+		if ( !FileExist( path ) )
+			return false;
+
+		FileSerializer file = new FileSerializer();
+		if ( !file.Open( path, FileMode.READ ) )
+			return false;
+
+		int version;
+		file.Read( version );
+
+		if ( version < 1 || version > VERSION )
+		{
+			file.Close();
+
+			#ifdef EXPANSIONEXLOGPRINT
+			EXLogPrint( "ExpansionPartyDatabase::Load - Invalid version; got " + version + ", expected [1, " + VERSION + "]" );
+			#endif
+
+			return false;
+		}
+
+		int count;
+		file.Read( count );
+
+		TIntArray partyIDs = new TIntArray;
+		file.Read( partyIDs );
+
+		if ( partyIDs.Count() != count )
+		{
+			file.Close();
+
+			#ifdef EXPANSIONEXLOGPRINT
+			EXLogPrint( "ExpansionPartyDatabase::Load - Corrupted header, " + partyIDs.Count() + " IDs for " + count + " parties" );
+			#endif
+
+			return false;
+		}
+
+		map< int, ref ExpansionPartySaveFormat > loaded = new map< int, ref ExpansionPartySaveFormat >;
+
+		for ( int i = 0; i < count; i++ )
+		{
+			ExpansionPartySaveFormat party = new ExpansionPartySaveFormat;
+			if ( !party.ReadCore( file ) || party.GetPartyID() != partyIDs[i] )
+			{
+				file.Close();
+
+				#ifdef EXPANSIONEXLOGPRINT
+				EXLogPrint( "ExpansionPartyDatabase::Load - Corrupted record " + i + ", expected party " + partyIDs[i] );
+				#endif
+
+				return false;
+			}
+
+			party.SetMarkersPending();
+
+			loaded.Insert( party.GetPartyID(), party );
+		}
+
+		file.Close();
+
+		//! Only hand out the parties once the whole file was read successfully
+		for ( int j = 0; j < loaded.Count(); j++ )
+		{
+			parties.Insert( loaded.GetKey( j ), loaded.GetElement( j ) );
+		}
+
+		#ifdef EXPANSIONEXLOGPRINT
+		EXLogPrint( "ExpansionPartyDatabase::Load - Loaded " + count + " parties from " + path );
+		#endif
+
+		return true;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionPartyDatabase Save
+	// ------------------------------------------------------------
+	static bool Save( string path, notnull map< int, ref ExpansionPartySaveFormat > parties )
+	{
+		string tempPath = path + ".tmp";
+
+		FileSerializer file = new FileSerializer();
+		if ( !file.Open( tempPath, FileMode.WRITE ) )
+		{
+			#ifdef EXPANSIONEXLOGPRINT
+			EXLogPrint( "ExpansionPartyDatabase::Save - Failed to open " + tempPath );
+			#endif
+
+			return false;
+		}
+
+		TIntArray partyIDs = new TIntArray;
+		int i;
+
+		for ( i = 0; i < parties.Count(); i++ )
+		{
+			if ( parties.GetElement( i ) )
+				partyIDs.Insert( parties.GetKey( i ) );
+		}
+
+		file.Write( VERSION );
+		file.Write( partyIDs.Count() );
+		file.Write( partyIDs );
+
+		for ( i = 0; i < partyIDs.Count(); i++ )
+		{
+			parties.Get( partyIDs[i] ).WriteCore( file );
+		}
+
+		file.Close();
+
+		//! Write to a temporary file first so an interrupted save never truncates the database
+		if ( !CopyFile( tempPath, path ) )
+			return false;
+
+		DeleteFile( tempPath );
+
+		return true;
+	}
+}
@@ -12,8 +12,22 @@
 
 class ExpansionPartyModule: JMModuleBase
 {
+	//! Quick marker changes are collected for this long before being sent to the party members
+	static const int QUICK_MARKER_SYNC_DELAY = 150;
+	//! Interval at which changed parties are written to disk
+	static const int PARTY_SAVE_INTERVAL = 30000;
+
 	//Server side
     private ref map< int, ref ExpansionPartySaveFormat > m_Parties;
+	//! Player UID -> party ID of the party the player is a member of
+	private ref map< string, int > m_PlayerParties;
+	//! Player UID -> IDs of the parties which invited the player
+	private ref map< string, ref TIntArray > m_PlayerInvites;
+	//! Party ID -> UIDs of the players whose quick marker changed since the last sync
+	private ref map< int, ref set< string > > m_QuickMarkerChanges;
+	private bool m_QuickMarkerSyncQueued;
+	//! A party was added or removed since the party database was last written
+	private bool m_DatabaseDirty;
 	
 	//Client side
 	private ref ExpansionPartySaveFormat m_Party;
@@ -32,6 +46,9 @@ class ExpansionPartyModule: JMModuleBase
 		
 		//Server
 		m_Parties = new map< int, ref ExpansionPartySaveFormat >;
+		m_PlayerParties = new map< string, int >;
+		m_PlayerInvites = new map< string, ref TIntArray >;
+		m_QuickMarkerChanges = new map< int, ref set< string > >;
 		
 		//Client
 		m_Party = null;
@@ -75,7 +92,89 @@ class ExpansionPartyModule: JMModuleBase
 		{
 			MakeDirectory( EXPANSION_GROUPS_FOLDER );
 		}
-				
+
+		if ( !FileExist( EXPANSION_GROUPS_MARKERS_FOLDER ) )
+		{
+			MakeDirectory( EXPANSION_GROUPS_MARKERS_FOLDER );
+		}
+
+		bool binary = GetExpansionSettings().GetParty().SavePartiesAsBinary;
+		bool fromDatabase = ExpansionPartyDatabase.Load( EXPANSION_GROUPS_DATABASE, m_Parties );
+		if ( !fromDatabase )
+		{
+			if ( FileExist( EXPANSION_GROUPS_DATABASE ) )
+			{
+				//! Keep the unreadable database around, it would be overwritten on the next save
+				Error( "[ExpansionPartyModule] Could not read " + EXPANSION_GROUPS_DATABASE + ", a copy was kept as " + EXPANSION_GROUPS_DATABASE + ".bak" );
+				CopyFile( EXPANSION_GROUPS_DATABASE, EXPANSION_GROUPS_DATABASE + ".bak" );
+			}
+
+			LoadPartyFiles();
+		}
+
+		for ( int i = 0; i < m_Parties.Count(); i++ )
+		{
+			ExpansionPartySaveFormat party = m_Parties.GetElement( i );
+			party.InitMaps();
+
+			IndexParty( party );
+
+			if ( m_NextPartyID <= party.GetPartyID() )
+			{
+				m_NextPartyID = party.GetPartyID() + 1;
+			}
+		}
+
+		//! Storage format was changed in the settings, convert everything right away
+		if ( binary != fromDatabase )
+		{
+			#ifdef EXPANSIONEXLOGPRINT
+			EXLogPrint( "ExpansionPartyModule::OnMissionStart - Converting " + m_Parties.Count() + " parties, binary : " + binary );
+			#endif
+
+			for ( int j = 0; j < m_Parties.Count(); j++ )
+			{
+				m_Parties.GetElement( j ).SetDirty();
+			}
+
+			m_DatabaseDirty = binary;
+
+			SaveParties();
+
+			//! Only drop the database once every party has its own file again
+			if ( !binary && HasPartyFiles() )
+				DeleteFile( EXPANSION_GROUPS_DATABASE );
+		}
+
+		GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).CallLater( SaveParties, PARTY_SAVE_INTERVAL, true );
+
+		#ifdef EXPANSIONEXPRINT
+		EXPrint("ExpansionPartyModule::OnMissionStart - End");
+		#endif
+    }
+	
+	// ------------------------------------------------------------
+	// Expansion HasPartyFiles
+	// Called on server
+	// ------------------------------------------------------------
+	private bool HasPartyFiles()
+	{
+		for ( int i = 0; i < m_Parties.Count(); i++ )
+		{
+			if ( !FileExist( EXPANSION_GROUPS_FOLDER + m_Parties.GetKey( i ) + ".json" ) )
+				return false;
+		}
+
+		return true;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion LoadPartyFiles
+	// Called on server
+	// Loads the parties stored one file per party
+	// ------------------------------------------------------------
+	private void LoadPartyFiles()
+	{
         array< string > group_files = FindFilesInLocation( EXPANSION_GROUPS_FOLDER );
 
         for ( int i = 0; i < group_files.Count(); i++ )
@@ -88,25 +187,70 @@ class ExpansionPartyModule: JMModuleBase
 				name = group_files[i].Substring( 0, pos );
 			}
 
-            ExpansionPartySaveFormat party;
-            JsonFileLoader< ExpansionPartySaveFormat >.JsonLoadFile( EXPANSION_GROUPS_FOLDER + name + ".json", party );
+            ExpansionPartySaveFormat party = ExpansionPartySaveFormat.Load( name );
 			if ( party )
 			{
-				party.InitMaps();
-				
 				m_Parties.Insert( party.GetPartyID(), party );
+			}
+        }
+	}
+	
+	// ------------------------------------------------------------
+	// Override OnMissionFinish
+	// ------------------------------------------------------------
+	override void OnMissionFinish()
+	{
+		super.OnMissionFinish();
+
+		if ( !IsMissionHost() )
+			return;
+
+		GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).Remove( SaveParties );
+
+		SaveParties();
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion SaveParties
+	// Called on server
+	// Writes the party database once if any party changed since the
+	// last PARTY_SAVE_INTERVAL, then the files of the dirty parties
+	// ------------------------------------------------------------
+	void SaveParties()
+	{
+		ExpansionPartySaveFormat party;
+		int i;
 
-				if ( m_NextPartyID <= party.GetPartyID() )
+		if ( GetExpansionSettings().GetParty().SavePartiesAsBinary )
+		{
+			for ( i = 0; i < m_Parties.Count(); ++i )
+			{
+				party = m_Parties.GetElement( i );
+				if ( party && party.IsDirty() )
+					m_DatabaseDirty = true;
+			}
+
+			//! Saving a party removes its own files, the database has to hold it first.
+			//! The parties stay dirty when it can't be written and are retried next time
+			if ( m_DatabaseDirty )
+			{
+				if ( !ExpansionPartyDatabase.Save( EXPANSION_GROUPS_DATABASE, m_Parties ) )
 				{
-					m_NextPartyID = party.GetPartyID() + 1;
+					Error( "[ExpansionPartyModule] Could not write " + EXPANSION_GROUPS_DATABASE );
+					return;
 				}
+
+				m_DatabaseDirty = false;
 			}
-        }
+		}
 
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionPartyModule::OnMissionStart - End");
-		#endif
-    }
+		for ( i = 0; i < m_Parties.Count(); ++i )
+		{
+			party = m_Parties.GetElement( i );
+			if ( party && party.IsDirty() )
+				party.Save();
+		}
+	}
 	
 	// ------------------------------------------------------------
 	// Override GetRPCMin
@@ -179,6 +323,9 @@ class ExpansionPartyModule: JMModuleBase
 		case ExpansionPartyModuleRPC.SyncQuickMarkers:
 			RPC_SyncQuickMarkers( ctx, sender, target );
 			break;
+		case ExpansionPartyModuleRPC.SyncQuickMarkerChanges:
+			RPC_SyncQuickMarkerChanges( ctx, sender, target );
+			break;
 		}
 	}
 	
@@ -220,14 +367,32 @@ class ExpansionPartyModule: JMModuleBase
 		array< ref ExpansionPartyInvite > invites = new array< ref ExpansionPartyInvite >;
 		string id = sender.GetIdentityUID();
 		
-		for (int i = 0; i < m_Parties.Count(); ++i)
+		TIntArray partyIDs = m_PlayerInvites.Get( id );
+		if ( partyIDs )
 		{
-			ref ExpansionPartySaveFormat party = m_Parties.GetElement(i);
-			if (party)
+			ref ExpansionPartySaveFormat party;
+			ref ExpansionPartyInvite invite;
+
+			for ( int i = partyIDs.Count() - 1; i >= 0; --i )
 			{
-				ref ExpansionPartyInvite invite = party.GetPlayerInvite(id);
-				if (invite) invites.Insert(invite);
+				party = m_Parties.Get( partyIDs[i] );
+				invite = NULL;
+				if ( party )
+					invite = party.GetPlayerInvite( id );
+
+				if ( invite )
+				{
+					invites.Insert( invite );
+				}
+				else
+				{
+					//! Stale entry, party or invite is gone
+					partyIDs.Remove( i );
+				}
 			}
+
+			if ( partyIDs.Count() == 0 )
+				m_PlayerInvites.Remove( id );
 		}
 		
 		#ifdef EXPANSIONEXLOGPRINT
@@ -312,9 +477,10 @@ class ExpansionPartyModule: JMModuleBase
 	
 	    ExpansionPartySaveFormat newParty = new ExpansionPartySaveFormat( m_NextPartyID );
 	    newParty.SetupExpansionPartySaveFormat( player, partyName );
-	    newParty.Save();
+	    newParty.SetDirty();
 	
 	    m_Parties.Insert( m_NextPartyID, newParty );
+		m_PlayerParties.Set( sender.GetId(), m_NextPartyID );
 
 		UpdateClient( m_NextPartyID++ );
 		
@@ -376,9 +542,14 @@ class ExpansionPartyModule: JMModuleBase
 			GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_PARTY_NOTIF_TITLE" ), new StringLocaliser( "STR_EXPANSION_PARTY_ERROR_SELF_NOT_IN" ), EXPANSION_NOTIFICATION_ICON_ERROR, COLOR_EXPANSION_NOTIFICATION_ERROR, 7, sender );
 			return;
 		}
+
+		m_PlayerParties.Remove( sender.GetId() );
+
+		if ( party.RemoveQuickMarker( sender.GetId() ) )
+			QueueQuickMarkerChange( party, sender.GetId() );
 		
 		UpdateClient( partyId );
-	    party.Save();
+	    party.SetDirty();
 		
 		Send_UpdateClient( null, player );
 
@@ -467,10 +638,12 @@ class ExpansionPartyModule: JMModuleBase
 	        if ( partyPlayer && partyPlayer.GetIdentity() )
 	        {
 				Send_UpdateClient( NULL, partyPlayer );
-				
-				GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_PARTY_NOTIF_TITLE" ), new StringLocaliser( "STR_EXPANSION_PARTY_PARTY_DISSOLVED" ), EXPANSION_NOTIFICATION_ICON_GROUP, COLOR_EXPANSION_NOTIFICATION_SUCCSESS, 7, partyPlayer.GetIdentity() );
 	        }
 	    }
+
+		ExpansionNotificationModule notificationModule;
+		if ( Class.CastTo( notificationModule, GetModuleManager().GetModule( ExpansionNotificationModule ) ) )
+			notificationModule.NotifyParty( new StringLocaliser( "STR_EXPANSION_PARTY_NOTIF_TITLE" ), new StringLocaliser( "STR_EXPANSION_PARTY_PARTY_DISSOLVED" ), EXPANSION_NOTIFICATION_ICON_GROUP, COLOR_EXPANSION_NOTIFICATION_SUCCSESS, 7, party );
 		
 		#ifdef EXPANSIONEXLOGPRINT
 		EXLogPrint("ExpansionPartyModule::Exec_Dissolve beforeDelete party : " + party);
@@ -478,11 +651,15 @@ class ExpansionPartyModule: JMModuleBase
 		
 	    party.Delete();
 
+		UnindexParty( party );
+		m_QuickMarkerChanges.Remove( partyId );
+
 		#ifdef EXPANSIONEXLOGPRINT
 		EXLogPrint("ExpansionPartyModule::Exec_Dissolve afterDelete party : " + party);
 		#endif
 
 		m_Parties.Remove( partyId );
+		m_DatabaseDirty = true;
     }
 	
 	// ------------------------------------------------------------
@@ -558,7 +735,8 @@ class ExpansionPartyModule: JMModuleBase
 		}
 	
 		ExpansionPartyInvite invite = party.AddInvite( targetID );
-	    party.Save();
+		AddPlayerInvite( targetID, partyId );
+	    party.SetDirty();
 		
 		UpdateClient( partyId );
 		
@@ -620,8 +798,10 @@ class ExpansionPartyModule: JMModuleBase
 			GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_PARTY_NOTIF_TITLE" ), new StringLocaliser( "STR_EXPANSION_PARTY_ERROR_PLAYER_NOT_IN" ), EXPANSION_NOTIFICATION_ICON_ERROR, COLOR_EXPANSION_NOTIFICATION_ERROR, 7, sender );
 			return;
 		}
+
+		RemovePlayerInvite( sender.GetId(), partyID );
 		
-		party.Save();
+		party.SetDirty();
 	    UpdateClient( partyID ); 
 		
 		SyncPlayersInvites( senderPlayer );
@@ -681,6 +861,13 @@ class ExpansionPartyModule: JMModuleBase
 			GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_PARTY_NOTIF_TITLE" ), new StringLocaliser( "STR_EXPANSION_PARTY_ERROR_MAX_PARTY", GetExpansionSettings().GetParty().MaxInParty.ToString() ), EXPANSION_NOTIFICATION_ICON_ERROR, COLOR_EXPANSION_NOTIFICATION_ERROR, 7, sender );
 			return;
 		}
+
+		//! A player can only be member of one party
+		if ( HasParty( senderPlayer ) )
+		{
+			GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_PARTY_NOTIF_TITLE" ), new StringLocaliser( "STR_EXPANSION_PARTY_ERROR_IN_PARTY" ), EXPANSION_NOTIFICATION_ICON_ERROR, COLOR_EXPANSION_NOTIFICATION_ERROR, 7, sender );
+			return;
+		}
 	
 		if ( !party.AcceptInvite( senderPlayer ) )
 		{
@@ -688,7 +875,10 @@ class ExpansionPartyModule: JMModuleBase
 			return;
 		}
 
-		party.Save();
+		RemovePlayerInvite( sender.GetId(), partyId );
+		m_PlayerParties.Set( sender.GetId(), partyId );
+
+		party.SetDirty();
 	
 		SyncPlayersInvites( senderPlayer );
 		
@@ -764,6 +954,7 @@ class ExpansionPartyModule: JMModuleBase
 		}
 		
 		targetPlayer.Promoted = true;
+		party.SetDirty();
 
 	    UpdateClient( partyId );
 		
@@ -842,6 +1033,7 @@ class ExpansionPartyModule: JMModuleBase
 		}
 		
 		targetPlayer.Promoted = false;
+		party.SetDirty();
 
 	    UpdateClient( partyId );
 		
@@ -919,9 +1111,14 @@ class ExpansionPartyModule: JMModuleBase
 			GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_PARTY_NOTIF_TITLE" ), new StringLocaliser( "STR_EXPANSION_PARTY_ERROR_PLAYER_NOT_IN" ), EXPANSION_NOTIFICATION_ICON_ERROR, COLOR_EXPANSION_NOTIFICATION_ERROR, 7, sender );
 			return;
 		}
+
+		m_PlayerParties.Remove( uid );
+
+		if ( party.RemoveQuickMarker( uid ) )
+			QueueQuickMarkerChange( party, uid );
 		
 	    UpdateClient( partyId );
-	    party.Save();
+	    party.SetDirty();
 		
 		PlayerBase targetPlayer = PlayerBase.GetPlayerByUID(uid);
 		
@@ -1012,6 +1209,9 @@ class ExpansionPartyModule: JMModuleBase
 	// ------------------------------------------------------------
 	private void Send_UpdateClient( ref ExpansionPartySaveFormat party, notnull PlayerIdentity toSendToParty )
 	{		
+		if ( party )
+			party.EnsureMarkers();
+
 		ScriptRPC rpc = new ScriptRPC();
 		rpc.Write( party );
 		rpc.Send( null, ExpansionPartyModuleRPC.UpdateClient, true, toSendToParty );
@@ -1025,6 +1225,9 @@ class ExpansionPartyModule: JMModuleBase
 	{
 		if ( !player || !player.GetIdentity() )
 			return;
+
+		if ( party )
+			party.EnsureMarkers();
 		
 		ScriptRPC rpc = new ScriptRPC();
 		rpc.Write( party );
@@ -1163,7 +1366,7 @@ class ExpansionPartyModule: JMModuleBase
 		}
 
 	    party.AddMarker( marker );
-	    party.Save();
+	    party.SetDirty();
 
 		GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_PARTY_NOTIF_TITLE" ), new StringLocaliser( "STR_EXPANSION_PARTY_MARKER_ADDED", marker.GetMarkerText() ), EXPANSION_NOTIFICATION_ICON_MARKER, COLOR_EXPANSION_NOTIFICATION_SUCCSESS, 7, sender );
 
@@ -1229,7 +1432,7 @@ class ExpansionPartyModule: JMModuleBase
 
 	    if ( party.RemoveMarker( name ) )
 	    {
-	        party.Save();
+	        party.SetDirty();
 
 			GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_PARTY_NOTIF_TITLE" ), new StringLocaliser( "STR_EXPANSION_PARTY_MARKER_REMOVED" ), EXPANSION_NOTIFICATION_ICON_MARKER, COLOR_EXPANSION_NOTIFICATION_SUCCSESS, 7, sender );
 	        
@@ -1295,7 +1498,7 @@ class ExpansionPartyModule: JMModuleBase
 
 	    if ( party.UpdateMarkerPosition( name, position ) )
 	    {
-	        party.Save();
+	        party.SetDirty();
 
 			GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_PARTY_NOTIF_TITLE" ), new StringLocaliser( "STR_EXPANSION_PARTY_MARKER_CHANGED" ), EXPANSION_NOTIFICATION_ICON_MARKER, COLOR_EXPANSION_NOTIFICATION_SUCCSESS, 7, sender );
 	    	UpdateClient( partyId );
@@ -1362,7 +1565,7 @@ class ExpansionPartyModule: JMModuleBase
 		if (position == vector.Zero)
 		{
 			if (party.RemoveQuickMarker(senderID))
-				SyncQuickMarkers(party);
+				QueueQuickMarkerChange(party, senderID);
 		}
 		else
 		{
@@ -1373,24 +1576,88 @@ class ExpansionPartyModule: JMModuleBase
 			
 			party.UpdateQuickMarker( quickMarker );
 			
-			SyncQuickMarkers(party);
+			QueueQuickMarkerChange(party, senderID);
 		}
 	}
 	
 	// -----------------------------------------------------------
-	// Expansion SyncQuickMarkers
+	// Expansion QueueQuickMarkerChange
+	// Called on server
+	// Marks the quick marker of the given player as changed, all changes
+	// made within QUICK_MARKER_SYNC_DELAY are sent together
 	// -----------------------------------------------------------
-	void SyncQuickMarkers(ref ExpansionPartySaveFormat party)
+	private void QueueQuickMarkerChange(notnull ExpansionPartySaveFormat party, string uid)
+	{
+		set< string > changes = m_QuickMarkerChanges.Get( party.GetPartyID() );
+		if ( !changes )
+		{
+			changes = new set< string >;
+			m_QuickMarkerChanges.Insert( party.GetPartyID(), changes );
+		}
+
+		if ( changes.Find( uid ) == -1 )
+			changes.Insert( uid );
+
+		if ( !m_QuickMarkerSyncQueued )
+		{
+			m_QuickMarkerSyncQueued = true;
+			GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).CallLater( SendQuickMarkerChanges, QUICK_MARKER_SYNC_DELAY, false );
+		}
+	}
+	
+	// -----------------------------------------------------------
+	// Expansion SendQuickMarkerChanges
+	// Called on server
+	// Sends the changed quick markers of each party to its online members.
+	// Markers which were removed are sent without position and color.
+	// -----------------------------------------------------------
+	private void SendQuickMarkerChanges()
+	{
+		m_QuickMarkerSyncQueued = false;
+
+		for ( int i = 0; i < m_QuickMarkerChanges.Count(); ++i )
+		{
+			ref ExpansionPartySaveFormat party = m_Parties.Get( m_QuickMarkerChanges.GetKey( i ) );
+			if ( !party )
+				continue;
+
+			set< string > changes = m_QuickMarkerChanges.GetElement( i );
+
+			ScriptRPC rpc = new ScriptRPC;
+			rpc.Write( changes.Count() );
+
+			for ( int j = 0; j < changes.Count(); ++j )
+			{
+				string uid = changes.Get( j );
+				ExpansionQuickMarker quickMarker = party.GetQuickMarker( uid );
+
+				rpc.Write( uid );
+				rpc.Write( quickMarker != NULL );
+
+				if ( quickMarker )
+				{
+					rpc.Write( quickMarker.Pos );
+					rpc.Write( quickMarker.Color );
+				}
+			}
+
+			SendToOnlineMembers( rpc, ExpansionPartyModuleRPC.SyncQuickMarkerChanges, party );
+		}
+
+		m_QuickMarkerChanges.Clear();
+	}
+	
+	// -----------------------------------------------------------
+	// Expansion SendToOnlineMembers
+	// Called on server
+	// Sends the same RPC buffer to every online member of the party
+	// -----------------------------------------------------------
+	private void SendToOnlineMembers(ScriptRPC rpc, int rpcType, notnull ExpansionPartySaveFormat party)
 	{
-		if ( !IsMissionHost() || !party)
-			return;
-		
 		ref array< ref ExpansionPartySaveFormatPlayer > players = party.GetPlayers();
 		if ( !players )
 			return;
 		
-		ref array<ref ExpansionQuickMarker> quickMarkers = party.GetQuickMarkers();
-		
 		for ( int i = 0; i < players.Count(); i++ )
 		{
 			ref ExpansionPartySaveFormatPlayer playerData = players[i];
@@ -1400,12 +1667,34 @@ class ExpansionPartyModule: JMModuleBase
 			if ( !player || !player.GetIdentity() )
 				continue;
 
-			ScriptRPC rpc = new ScriptRPC;
-			rpc.Write(quickMarkers);
-			rpc.Send(null, ExpansionPartyModuleRPC.SyncQuickMarkers, true, player.GetIdentity());
+			rpc.Send(null, rpcType, true, player.GetIdentity());
 		}
 	}
 	
+	// -----------------------------------------------------------
+	// Expansion SyncQuickMarkers
+	// Called on server
+	// Sends all quick markers of the party, to the given player only if set
+	// -----------------------------------------------------------
+	void SyncQuickMarkers(ref ExpansionPartySaveFormat party, PlayerBase player = NULL)
+	{
+		if ( !IsMissionHost() || !party)
+			return;
+		
+		ScriptRPC rpc = new ScriptRPC;
+		rpc.Write(party.GetQuickMarkers());
+		
+		if ( player )
+		{
+			if ( player.GetIdentity() )
+				rpc.Send(null, ExpansionPartyModuleRPC.SyncQuickMarkers, true, player.GetIdentity());
+
+			return;
+		}
+		
+		SendToOnlineMembers(rpc, ExpansionPartyModuleRPC.SyncQuickMarkers, party);
+	}
+	
 	// -----------------------------------------------------------
 	// Expansion RPC_SyncQuickMarkers
 	// -----------------------------------------------------------
@@ -1433,7 +1722,76 @@ class ExpansionPartyModule: JMModuleBase
 		
 		Expansion3DMarkerModule module;
 		if ( Class.CastTo( module, GetModuleManager().GetModule( Expansion3DMarkerModule ) ) )
-			module.RefreshMarkers();
+			module.RefreshQuickMarkers();
+	}
+	
+	// -----------------------------------------------------------
+	// Expansion RPC_SyncQuickMarkerChanges
+	// Called on client
+	// -----------------------------------------------------------
+	private void RPC_SyncQuickMarkerChanges( ref ParamsReadContext ctx, PlayerIdentity senderRPC, Object target )
+	{
+		if (!IsMissionClient())
+			return;
+		
+		int count;
+		if ( !ctx.Read( count ) )
+			return;
+
+		Expansion3DMarkerModule module = Expansion3DMarkerModule.Cast( GetModuleManager().GetModule( Expansion3DMarkerModule ) );
+		
+		for ( int i = 0; i < count; ++i )
+		{
+			string uid;
+			if ( !ctx.Read( uid ) )
+				return;
+
+			bool exists;
+			if ( !ctx.Read( exists ) )
+				return;
+
+			if ( !exists )
+			{
+				int index = -1;
+				if ( m_Party )
+					index = m_Party.FindQuickMarker( uid );
+
+				if ( index > -1 )
+				{
+					m_Party.GetQuickMarkers().Remove( index );
+
+					if ( module )
+						module.RemoveQuickMarker( uid );
+				}
+
+				continue;
+			}
+
+			vector pos;
+			if ( !ctx.Read( pos ) )
+				return;
+
+			int color;
+			if ( !ctx.Read( color ) )
+				return;
+
+			if ( !m_Party )
+				continue;
+
+			ExpansionQuickMarker quickMarker = m_Party.GetQuickMarker( uid );
+			if ( !quickMarker )
+			{
+				quickMarker = new ExpansionQuickMarker;
+				quickMarker.UID = uid;
+				m_Party.GetQuickMarkers().Insert( quickMarker );
+			}
+
+			quickMarker.Pos = pos;
+			quickMarker.Color = color;
+
+			if ( module )
+				module.UpdateQuickMarker( quickMarker );
+		}
 	}
 
 	// -----------------------------------------------------------
@@ -1458,27 +1816,20 @@ class ExpansionPartyModule: JMModuleBase
 		
 		FindAndSyncPlayerInvites( player, identity );
 
-		for ( int i = 0; i < m_Parties.Count(); ++i )
+		ref ExpansionPartySaveFormat party = m_Parties.Get( GetPartyID( identity.GetId() ) );
+		if ( party )
 		{
-			ref ExpansionPartySaveFormat party = m_Parties.GetElement(i);
-			if ( party )
-			{
-				ref ExpansionPartySaveFormatPlayer pFormat = party.GetPlayer( identity.GetId() );
-				if ( pFormat )
-				{
-					#ifdef EXPANSIONEXLOGPRINT
-					EXLogPrint("ExpansionPartyModule::OnPlayerConnect found a party : " + party.GetPartyName());
-					#endif
-					
-					//Update all others clients
-	    			UpdateClient( party.GetPartyID() );
-					
-					//Update our current client
-					UpdateClient( party.GetPartyID(), player );
-					
-					SyncQuickMarkers(party);
-				}
-			}
+			#ifdef EXPANSIONEXLOGPRINT
+			EXLogPrint("ExpansionPartyModule::OnPlayerConnect found a party : " + party.GetPartyName());
+			#endif
+			
+			//Update all others clients
+			UpdateClient( party.GetPartyID() );
+			
+			//Update our current client
+			UpdateClient( party.GetPartyID(), player );
+			
+			SyncQuickMarkers(party, player);
 		}
 		
 		#ifdef EXPANSIONEXLOGPRINT
@@ -1502,7 +1853,7 @@ class ExpansionPartyModule: JMModuleBase
 		}
 		
 		if (party.RemoveQuickMarker(player.GetIdentityUID()))
-			SyncQuickMarkers(party);
+			QueueQuickMarkerChange(party, player.GetIdentityUID());
 	}
 	
 	// -----------------------------------------------------------
@@ -1541,23 +1892,11 @@ class ExpansionPartyModule: JMModuleBase
 	// -----------------------------------------------------------
 	void SendNotificationToMembers( StringLocaliser text, ExpansionPartySaveFormat party, PlayerIdentity sender )
 	{
-		ref array< ref ExpansionPartySaveFormatPlayer > players = party.GetPlayers();	
-	   	if ( !players ) return;
-		
-		for ( int i = 0; i < players.Count(); i++ )
-	    {
-			ref ExpansionPartySaveFormatPlayer playerData = players[i];
-			if (!playerData) continue;
-			
-			PlayerBase partyPlayer = PlayerBase.GetPlayerByUID( playerData.UID );			
-	        if ( partyPlayer && partyPlayer.GetIdentity() )
-	        {					
-				if ( partyPlayer.GetIdentityUID() != sender.GetId() )
-				{
-					GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_PARTY_NOTIF_TITLE" ), text, EXPANSION_NOTIFICATION_ICON_GROUP, COLOR_EXPANSION_NOTIFICATION_SUCCSESS, 7, partyPlayer.GetIdentity() );
-				}
-	        }
-	    }
+		ExpansionNotificationModule notificationModule;
+		if ( !Class.CastTo( notificationModule, GetModuleManager().GetModule( ExpansionNotificationModule ) ) )
+			return;
+
+		notificationModule.NotifyParty( new StringLocaliser( "STR_EXPANSION_PARTY_NOTIF_TITLE" ), text, EXPANSION_NOTIFICATION_ICON_GROUP, COLOR_EXPANSION_NOTIFICATION_SUCCSESS, 7, party, sender.GetId() );
 	}
 	
 	// -----------------------------------------------------------
@@ -1578,19 +1917,7 @@ class ExpansionPartyModule: JMModuleBase
 	// -----------------------------------------------------------
 	bool HasParty( PlayerBase player )
 	{
-		if ( IsMissionHost() )
-		{				
-			for( int i = 0; i < m_Parties.Count(); ++i )
-			{
-				ref ExpansionPartySaveFormat party = m_Parties.GetElement(i);
-				if ( party && party.GetPlayer( player.GetIdentityUID() ) )
-				{
-					return true;
-				}
-			}
-		}
-		
-		return false;
+		return GetPartyID( player ) != -1;
 	}
 	
 	// ------------------------------------------------------------
@@ -1611,23 +1938,125 @@ class ExpansionPartyModule: JMModuleBase
 	// -----------------------------------------------------------
 	int GetPartyID(PlayerBase player)
 	{
-		if (!IsMissionHost() || player.GetIdentityUID() == "") return -1;
-		
-		string id = player.GetIdentityUID();
+		if (!IsMissionHost() || !player) return -1;
 		
-		for (int i = 0; i < m_Parties.Count(); ++i)
+		return GetPartyID( player.GetIdentityUID() );
+	}
+
+	// -----------------------------------------------------------
+	// Expansion GetPartyID
+	// Called on server
+	// -----------------------------------------------------------
+	int GetPartyID( string uid )
+	{
+		if ( !IsMissionHost() || uid == "" )
+			return -1;
+
+		int partyId;
+		if ( !m_PlayerParties.Find( uid, partyId ) )
+			return -1;
+
+		ref ExpansionPartySaveFormat party = m_Parties.Get( partyId );
+		if ( !party || !party.GetPlayer( uid ) )
 		{
-			ref ExpansionPartySaveFormat party = m_Parties.GetElement(i);
-			if (party)
+			//! Stale entry, should not happen as long as every membership change goes through the index
+			m_PlayerParties.Remove( uid );
+			return -1;
+		}
+
+		return partyId;
+	}
+
+	// -----------------------------------------------------------
+	// Expansion IndexParty
+	// Called on server
+	// Adds the members and invites of the given party to the lookup maps
+	// -----------------------------------------------------------
+	private void IndexParty( notnull ExpansionPartySaveFormat party )
+	{
+		int partyId = party.GetPartyID();
+
+		array< ref ExpansionPartySaveFormatPlayer > players = party.GetPlayers();
+		for ( int i = 0; i < players.Count(); ++i )
+		{
+			if ( !players[i] )
+				continue;
+
+			if ( m_PlayerParties.Contains( players[i].UID ) )
 			{
-				if (party.GetPlayer(id))
-				{
-					return party.GetPartyID();
-				}
+				//! Legacy data can have a player in several parties, the first one loaded wins
+				#ifdef EXPANSIONEXLOGPRINT
+				EXLogPrint("ExpansionPartyModule::IndexParty - " + players[i].UID + " is already member of party " + m_PlayerParties.Get( players[i].UID ) + ", ignoring membership in party " + partyId);
+				#endif
+
+				continue;
 			}
+
+			m_PlayerParties.Insert( players[i].UID, partyId );
 		}
-		
-		return -1;
+
+		array< ref ExpansionPartyInvite > invites = party.GetInvites();
+		for ( int j = 0; j < invites.Count(); ++j )
+		{
+			if ( invites[j] )
+				AddPlayerInvite( invites[j].UID, partyId );
+		}
+	}
+
+	// -----------------------------------------------------------
+	// Expansion UnindexParty
+	// Called on server
+	// -----------------------------------------------------------
+	private void UnindexParty( notnull ExpansionPartySaveFormat party )
+	{
+		int partyId = party.GetPartyID();
+
+		array< ref ExpansionPartySaveFormatPlayer > players = party.GetPlayers();
+		for ( int i = 0; i < players.Count(); ++i )
+		{
+			if ( players[i] && m_PlayerParties.Get( players[i].UID ) == partyId )
+				m_PlayerParties.Remove( players[i].UID );
+		}
+
+		array< ref ExpansionPartyInvite > invites = party.GetInvites();
+		for ( int j = 0; j < invites.Count(); ++j )
+		{
+			if ( invites[j] )
+				RemovePlayerInvite( invites[j].UID, partyId );
+		}
+	}
+
+	// -----------------------------------------------------------
+	// Expansion AddPlayerInvite
+	// Called on server
+	// -----------------------------------------------------------
+	private void AddPlayerInvite( string uid, int partyId )
+	{
+		TIntArray partyIDs = m_PlayerInvites.Get( uid );
+		if ( !partyIDs )
+		{
+			partyIDs = new TIntArray;
+			m_PlayerInvites.Insert( uid, partyIDs );
+		}
+
+		if ( partyIDs.Find( partyId ) == -1 )
+			partyIDs.Insert( partyId );
+	}
+
+	// -----------------------------------------------------------
+	// Expansion RemovePlayerInvite
+	// Called on server
+	// -----------------------------------------------------------
+	private void RemovePlayerInvite( string uid, int partyId )
+	{
+		TIntArray partyIDs = m_PlayerInvites.Get( uid );
+		if ( !partyIDs )
+			return;
+
+		partyIDs.RemoveItem( partyId );
+
+		if ( partyIDs.Count() == 0 )
+			m_PlayerInvites.Remove( uid );
 	}
 
 	// ------------------------------------------------------------
@@ -26,7 +26,6 @@ class ExpansionPartySaveFormatPlayer
 
 class ExpansionQuickMarker
 {
-	[NonSerialized()]
 	string UID;
 	
 	vector Pos;
@@ -35,6 +34,9 @@ class ExpansionQuickMarker
 
 class ExpansionPartySaveFormat 
 {
+	//! Version of the GroupMarkers/<id>.bin marker files
+	static const int BINARY_VERSION = 1;
+
     protected int PartyID;
 
     protected string PartyName;
@@ -55,6 +57,12 @@ class ExpansionPartySaveFormat
 	
 	[NonSerialized()]
 	protected autoptr array<ref ExpansionQuickMarker> m_QuickMarkers;
+
+	[NonSerialized()]
+	protected bool m_IsDirty;
+
+	[NonSerialized()]
+	protected bool m_MarkersLoaded;
 		
 	// ------------------------------------------------------------
 	// Expansion ExpansionPartySaveFormat Consturctor
@@ -72,6 +80,8 @@ class ExpansionPartySaveFormat
 		InvitesMap = new map< string, ref ExpansionPartyInvite >;
 		
 		m_QuickMarkers = new array<ref ExpansionQuickMarker>;
+
+		m_MarkersLoaded = true;
     }
 	
 	// ------------------------------------------------------------
@@ -106,7 +116,7 @@ class ExpansionPartySaveFormat
 		
 		for ( int j = 0; j < Invites.Count(); ++j )
 		{
-			ref ExpansionPartyInvite invite = Invites[i];
+			ref ExpansionPartyInvite invite = Invites[j];
 			if (invite)
 			{
 				InvitesMap.Insert( invite.UID, invite );
@@ -141,40 +151,60 @@ class ExpansionPartySaveFormat
 		if (!m_QuickMarkers)
 			m_QuickMarkers = new array<ref ExpansionQuickMarker>;
 		
-		for (int i = 0; i < m_QuickMarkers.Count(); ++i)
+		int i = FindQuickMarker( quickMarker.UID );
+		if ( i > -1 )
 		{
-			if (m_QuickMarkers[i] && m_QuickMarkers[i].UID == quickMarker.UID)
-			{
-				delete m_QuickMarkers[i];
-				m_QuickMarkers[i] = quickMarker;
-				return;
-			}
+			m_QuickMarkers[i] = quickMarker;
+			return;
 		}
 		
 		m_QuickMarkers.Insert( quickMarker );
 	}
 	
 	// ------------------------------------------------------------
-	// Expansion UpdateQuickMarker
+	// Expansion RemoveQuickMarker
 	// ------------------------------------------------------------
 	bool RemoveQuickMarker(string id)
 	{
 		if (!IsMissionHost())
 			return false;
 		
+		int i = FindQuickMarker( id );
+		if ( i == -1 )
+			return false;
+		
+		m_QuickMarkers.Remove( i );
+		return true;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion FindQuickMarker
+	// Returns the index of the quick marker of the given player, -1 if there is none
+	// ------------------------------------------------------------
+	int FindQuickMarker(string id)
+	{
 		if (!m_QuickMarkers)
-			m_QuickMarkers = new array<ref ExpansionQuickMarker>;
+			return -1;
 		
 		for (int i = 0; i < m_QuickMarkers.Count(); ++i)
 		{
 			if (m_QuickMarkers[i] && m_QuickMarkers[i].UID == id)
-			{
-				m_QuickMarkers.Remove(i);
-				return true;
-			}
+				return i;
 		}
 		
-		return false;
+		return -1;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion GetQuickMarker
+	// ------------------------------------------------------------
+	ExpansionQuickMarker GetQuickMarker(string id)
+	{
+		int i = FindQuickMarker( id );
+		if ( i == -1 )
+			return NULL;
+		
+		return m_QuickMarkers[i];
 	}
 	
 	// ------------------------------------------------------------
@@ -201,11 +231,21 @@ class ExpansionPartySaveFormat
         return Players;
     }
 	
+	// ------------------------------------------------------------
+	// Expansion GetInvites
+	// ------------------------------------------------------------
+    ref array< ref ExpansionPartyInvite > GetInvites()
+    {
+        return Invites;
+    }
+	
 	// ------------------------------------------------------------
 	// Expansion GetAllMarkers
 	// ------------------------------------------------------------
     ref array<ref ExpansionMapMarker> GetAllMarkers()
     {
+		EnsureMarkers();
+
         return Markers;
     }
 	
@@ -214,7 +254,15 @@ class ExpansionPartySaveFormat
 	// ------------------------------------------------------------
     void SetupExpansionPartySaveFormat( PlayerBase pPb, string partyName )
     {
-       	ref ExpansionPartySaveFormatPlayer player = AddPlayer( pPb, true );
+		SetupExpansionPartySaveFormat( pPb.GetIdentityUID(), pPb.GetIdentityName(), partyName );
+    }
+
+	// ------------------------------------------------------------
+	// Expansion SetupExpansionPartySaveFormat
+	// ------------------------------------------------------------
+    void SetupExpansionPartySaveFormat( string ownerUID, string ownerName, string partyName )
+    {
+       	ref ExpansionPartySaveFormatPlayer player = AddMember( ownerUID, ownerName, true );
 
         PartyName = partyName;
         OwnerUID = player.UID;
@@ -226,9 +274,14 @@ class ExpansionPartySaveFormat
 	// ------------------------------------------------------------
     private ref ExpansionPartySaveFormatPlayer AddPlayer( PlayerBase pPb, bool owner = false )
     {
-        string uid = pPb.GetIdentityUID();
-		string name = pPb.GetIdentityName();
+        return AddMember( pPb.GetIdentityUID(), pPb.GetIdentityName(), owner );
+    }
 
+	// ------------------------------------------------------------
+	// Expansion AddMember
+	// ------------------------------------------------------------
+    ref ExpansionPartySaveFormatPlayer AddMember( string uid, string name, bool owner = false )
+    {
 		ExpansionPartySaveFormatPlayer player = new ExpansionPartySaveFormatPlayer;
 		player.UID = uid;
 		player.Name = name;
@@ -360,6 +413,8 @@ class ExpansionPartySaveFormat
 	// ------------------------------------------------------------
     void AddMarker( ref ExpansionMapMarker marker )
     {
+		EnsureMarkers();
+
         Markers.Insert( marker );
     }
 		
@@ -368,6 +423,8 @@ class ExpansionPartySaveFormat
 	// ------------------------------------------------------------
     bool RemoveMarker( string markerName )
     {
+		EnsureMarkers();
+
         for ( int i = 0; i < Markers.Count(); ++i )
         {
             if ( Markers.Get(i).GetMarkerText() == markerName )
@@ -385,6 +442,8 @@ class ExpansionPartySaveFormat
 	// ------------------------------------------------------------
 	bool UpdateMarkerPosition( string markerName, vector markerPosition )
 	{
+		EnsureMarkers();
+
 		for ( int i = 0; i < Markers.Count(); ++i )
         {
             if ( Markers[i] && Markers[i].GetMarkerText() == markerName )
@@ -413,15 +472,267 @@ class ExpansionPartySaveFormat
         return OwnerUID;
     }
 		
+	// ------------------------------------------------------------
+	// Expansion IsDirty
+	// ------------------------------------------------------------
+	bool IsDirty()
+	{
+		return m_IsDirty;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion SetDirty
+	// Marks the party to be written on the next flush
+	// ------------------------------------------------------------
+	void SetDirty()
+	{
+		m_IsDirty = true;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion SetMarkersPending
+	// Markers are read from their own file the first time they are needed
+	// ------------------------------------------------------------
+	void SetMarkersPending()
+	{
+		m_MarkersLoaded = false;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion EnsureMarkers
+	// ------------------------------------------------------------
+	void EnsureMarkers()
+	{
+		if ( m_MarkersLoaded )
+			return;
+
+		m_MarkersLoaded = true;
+
+		string path = GetMarkersPath();
+		if ( !FileExist( path ) )
+			return;
+
+		FileSerializer file = new FileSerializer();
+		if ( !file.Open( path, FileMode.READ ) )
+			return;
+
+		int version;
+		if ( file.Read( version ) && version >= 1 && version <= BINARY_VERSION )
+		{
+			ReadMarkers( file );
+		}
+		else
+		{
+			#ifdef EXPANSIONEXLOGPRINT
+			EXLogPrint( "ExpansionPartySaveFormat::EnsureMarkers - Invalid marker file " + path );
+			#endif
+		}
+
+		file.Close();
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion GetMarkersPath
+	// ------------------------------------------------------------
+	private string GetMarkersPath()
+	{
+		return EXPANSION_GROUPS_MARKERS_FOLDER + PartyID + ".bin";
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion Load
+	// Loads a party stored in its own JSON file
+	// ------------------------------------------------------------
+	static ExpansionPartySaveFormat Load( string name )
+	{
+		string path = EXPANSION_GROUPS_FOLDER + name + ".json";
+		if ( !FileExist( path ) )
+			return NULL;
+
+		ExpansionPartySaveFormat party;
+		JsonFileLoader< ExpansionPartySaveFormat >.JsonLoadFile( path, party );
+
+		return party;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion ReadCore
+	// Everything but the markers
+	// ------------------------------------------------------------
+	bool ReadCore( FileSerializer file )
+	{
+		if ( !file.Read( PartyID ) )
+			return false;
+
+		file.Read( PartyName );
+		file.Read( OwnerUID );
+		file.Read( OwnerName );
+
+		int count;
+		int i;
+
+		file.Read( count );
+		for ( i = 0; i < count; i++ )
+		{
+			ExpansionPartySaveFormatPlayer player = new ExpansionPartySaveFormatPlayer;
+			file.Read( player.UID );
+			file.Read( player.Name );
+			file.Read( player.Promoted );
+
+			Players.Insert( player );
+		}
+
+		file.Read( count );
+		for ( i = 0; i < count; i++ )
+		{
+			ExpansionPartyInvite invite = new ExpansionPartyInvite;
+			file.Read( invite.partyID );
+			file.Read( invite.partyName );
+			file.Read( invite.UID );
+
+			Invites.Insert( invite );
+		}
+
+		return true;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion WriteCore
+	// ------------------------------------------------------------
+	void WriteCore( FileSerializer file )
+	{
+		int i;
+
+		file.Write( PartyID );
+		file.Write( PartyName );
+		file.Write( OwnerUID );
+		file.Write( OwnerName );
+
+		file.Write( Players.Count() );
+		for ( i = 0; i < Players.Count(); i++ )
+		{
+			file.Write( Players[i].UID );
+			file.Write( Players[i].Name );
+			file.Write( Players[i].Promoted );
+		}
+
+		file.Write( Invites.Count() );
+		for ( i = 0; i < Invites.Count(); i++ )
+		{
+			file.Write( Invites[i].partyID );
+			file.Write( Invites[i].partyName );
+			file.Write( Invites[i].UID );
+		}
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion ReadMarkers
+	// ------------------------------------------------------------
+	private bool ReadMarkers( FileSerializer file )
+	{
+		int count;
+		if ( !file.Read( count ) )
+			return false;
+
+		Markers.Clear();
+
+		for ( int i = 0; i < count; i++ )
+		{
+			string text;
+			int iconIndex;
+			vector position;
+			int color;
+			bool partyMarker;
+			bool marker3D;
+
+			file.Read( text );
+			file.Read( iconIndex );
+			file.Read( position );
+			file.Read( color );
+			file.Read( partyMarker );
+			file.Read( marker3D );
+
+			Markers.Insert( new ExpansionMapMarker( text, iconIndex, position, color, partyMarker, marker3D ) );
+		}
+
+		return true;
+	}
+	
+	// ------------------------------------------------------------
+	// Expansion WriteMarkers
+	// ------------------------------------------------------------
+	private void WriteMarkers( FileSerializer file )
+	{
+		file.Write( Markers.Count() );
+		for ( int i = 0; i < Markers.Count(); i++ )
+		{
+			ExpansionMapMarker marker = Markers[i];
+			file.Write( marker.GetMarkerText() );
+			file.Write( marker.GetIconIndex() );
+			file.Write( marker.GetMarkerPosition() );
+			file.Write( marker.GetMarkerColor() );
+			file.Write( marker.IsPartyMarker() );
+			file.Write( marker.Is3DMarker() );
+		}
+	}
+	
 	// ------------------------------------------------------------
 	// Expansion Save
+	// Writes the party as JSON, or only its markers when parties are
+	// stored in the party database, which holds the rest.
+	// The file of the other storage is removed so only one copy exists on disk.
 	// ------------------------------------------------------------
     void Save() 
     {
         if ( !IsMissionHost() )
             return;
 
-        JsonFileLoader<ExpansionPartySaveFormat>.JsonSaveFile( EXPANSION_GROUPS_FOLDER + PartyID + ".json", this );
+		string jsonPath = EXPANSION_GROUPS_FOLDER + PartyID + ".json";
+		string markersPath = GetMarkersPath();
+
+		if ( !GetExpansionSettings().GetParty().SavePartiesAsBinary )
+		{
+			EnsureMarkers();
+
+        	JsonFileLoader<ExpansionPartySaveFormat>.JsonSaveFile( jsonPath, this );
+
+			if ( FileExist( markersPath ) )
+				DeleteFile( markersPath );
+
+			m_IsDirty = false;
+			return;
+		}
+
+		if ( FileExist( jsonPath ) )
+			DeleteFile( jsonPath );
+
+		m_IsDirty = false;
+
+		//! Markers which were never loaded did not change
+		if ( !m_MarkersLoaded )
+			return;
+
+		string tempPath = markersPath + ".tmp";
+
+		FileSerializer file = new FileSerializer();
+		if ( !file.Open( tempPath, FileMode.WRITE ) )
+		{
+			#ifdef EXPANSIONEXLOGPRINT
+			EXLogPrint( "ExpansionPartySaveFormat::Save - Failed to save party markers " + markersPath );
+			#endif
+
+			m_IsDirty = true;
+			return;
+		}
+
+		file.Write( BINARY_VERSION );
+		WriteMarkers( file );
+		file.Close();
+
+		if ( CopyFile( tempPath, markersPath ) )
+			DeleteFile( tempPath );
+		else
+			m_IsDirty = true;
     }
 	
 	// ------------------------------------------------------------
@@ -432,6 +743,12 @@ class ExpansionPartySaveFormat
         if ( !IsMissionHost() )
             return;
             
-        DeleteFile( EXPANSION_GROUPS_FOLDER + PartyID + ".json" );
+		if ( FileExist( EXPANSION_GROUPS_FOLDER + PartyID + ".json" ) )
+        	DeleteFile( EXPANSION_GROUPS_FOLDER + PartyID + ".json" );
+
+		if ( FileExist( GetMarkersPath() ) )
+			DeleteFile( GetMarkersPath() );
+
+		m_IsDirty = false;
     }
 }
\ No newline at end of file
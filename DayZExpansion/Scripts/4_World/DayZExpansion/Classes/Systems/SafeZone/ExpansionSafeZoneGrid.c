@@ -0,0 +1,453 @@
+/**
+ * ExpansionSafeZoneGrid.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2020 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionSafeZoneGridCell
+ * @brief		One cell of the safezone grid. Either fully inside a zone,
+ *				or holding the zones which cross its borders.
+ **/
+class ExpansionSafeZoneGridCell
+{
+	bool Inside;
+
+	autoptr array< int > Circles;
+	autoptr array< int > Polygons;
+
+	// ------------------------------------------------------------
+	// Expansion ExpansionSafeZoneGridCell
+	// ------------------------------------------------------------
+	void ExpansionSafeZoneGridCell()
+	{
+		Circles = new array< int >;
+		Polygons = new array< int >;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion SetInside
+	// ------------------------------------------------------------
+	void SetInside()
+	{
+		Inside = true;
+
+		Circles.Clear();
+		Polygons.Clear();
+	}
+}
+
+/**@class		ExpansionSafeZoneGrid
+ * @brief		Uniform grid built from the safezone settings, mapping each
+ *				world cell to the zones that can contain a position in it.
+ *				Cells which are not stored are outside of every zone.
+ **/
+class ExpansionSafeZoneGrid
+{
+	static const float CELL_SIZE = 100.0;
+
+	protected ExpansionSafeZoneSettings m_Settings;
+
+	protected autoptr map< int, ref ExpansionSafeZoneGridCell > m_Cells;
+
+	protected float m_MinX;
+	protected float m_MinZ;
+	protected int m_Columns;
+	protected int m_Rows;
+
+	// ------------------------------------------------------------
+	// Expansion ExpansionSafeZoneGrid
+	// ------------------------------------------------------------
+	void ExpansionSafeZoneGrid()
+	{
+		m_Cells = new map< int, ref ExpansionSafeZoneGridCell >;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion Build
+	// ------------------------------------------------------------
+	void Build( ExpansionSafeZoneSettings settings )
+	{
+		#ifdef EXPANSIONEXPRINT
+		EXPrint("ExpansionSafeZoneGrid::Build - Start");
+		#endif
+
+		m_Settings = settings;
+		m_Cells.Clear();
+		m_Columns = 0;
+		m_Rows = 0;
+
+		if ( !m_Settings || !m_Settings.CircleZones || !m_Settings.PolygonZones )
+			return;
+
+		int i;
+		int k;
+
+		float minX = float.MAX;
+		float minZ = float.MAX;
+		float maxX = -float.MAX;
+		float maxZ = -float.MAX;
+
+		for ( i = 0; i < m_Settings.CircleZones.Count(); ++i )
+		{
+			ExpansionSafeZoneCircle circle = m_Settings.CircleZones[i];
+			if ( !circle )
+				continue;
+
+			minX = Math.Min( minX, circle.Center[0] - circle.Radius );
+			minZ = Math.Min( minZ, circle.Center[2] - circle.Radius );
+			maxX = Math.Max( maxX, circle.Center[0] + circle.Radius );
+			maxZ = Math.Max( maxZ, circle.Center[2] + circle.Radius );
+		}
+
+		for ( i = 0; i < m_Settings.PolygonZones.Count(); ++i )
+		{
+			ExpansionSafeZonePolygon polygon = m_Settings.PolygonZones[i];
+			if ( !polygon || !polygon.Positions )
+				continue;
+
+			for ( k = 0; k < polygon.Positions.Count(); ++k )
+			{
+				minX = Math.Min( minX, polygon.Positions[k][0] );
+				minZ = Math.Min( minZ, polygon.Positions[k][2] );
+				maxX = Math.Max( maxX, polygon.Positions[k][0] );
+				maxZ = Math.Max( maxZ, polygon.Positions[k][2] );
+			}
+		}
+
+		//! No zone at all, every position is outside
+		if ( minX > maxX || minZ > maxZ )
+			return;
+
+		m_MinX = minX;
+		m_MinZ = minZ;
+		m_Columns = Math.Floor( ( maxX - minX ) / CELL_SIZE ) + 1;
+		m_Rows = Math.Floor( ( maxZ - minZ ) / CELL_SIZE ) + 1;
+
+		for ( i = 0; i < m_Settings.CircleZones.Count(); ++i )
+		{
+			AddCircle( i, m_Settings.CircleZones[i] );
+		}
+
+		for ( i = 0; i < m_Settings.PolygonZones.Count(); ++i )
+		{
+			AddPolygon( i, m_Settings.PolygonZones[i] );
+		}
+
+		#ifdef EXPANSIONEXLOGPRINT
+		EXLogPrint("[ExpansionSafeZoneGrid] Built " + m_Columns + "x" + m_Rows + " grid, " + m_Cells.Count() + " cells in use");
+		#endif
+
+		#ifdef EXPANSIONEXPRINT
+		EXPrint("ExpansionSafeZoneGrid::Build - End");
+		#endif
+	}
+
+	// ------------------------------------------------------------
+	// Expansion IsInside
+	// ------------------------------------------------------------
+	bool IsInside( vector position )
+	{
+		ExpansionSafeZoneGridCell cell = m_Cells.Get( GetCellIndex( position[0], position[2] ) );
+		if ( !cell )
+			return false;
+
+		if ( cell.Inside )
+			return true;
+
+		int i;
+
+		//! Circles first, they are cheaper than polygons
+		for ( i = 0; i < cell.Circles.Count(); ++i )
+		{
+			ExpansionSafeZoneCircle circle = m_Settings.CircleZones[cell.Circles[i]];
+
+			float xPower = circle.Center[0] - position[0];
+			float zPower = circle.Center[2] - position[2];
+
+			if ( ( xPower * xPower ) + ( zPower * zPower ) < ( circle.Radius * circle.Radius ) )
+				return true;
+		}
+
+		for ( i = 0; i < cell.Polygons.Count(); ++i )
+		{
+			ExpansionSafeZonePolygon polygon = m_Settings.PolygonZones[cell.Polygons[i]];
+
+			//! Bounding circle pre-reject before doing the ray cast
+			if ( polygon.RadiusPolygon > 0 )
+			{
+				float xCenter = polygon.CenterPolygon[0] - position[0];
+				float zCenter = polygon.CenterPolygon[2] - position[2];
+
+				if ( ( xCenter * xCenter ) + ( zCenter * zCenter ) > ( polygon.RadiusPolygon * polygon.RadiusPolygon ) )
+					continue;
+			}
+
+			if ( IsInsidePolygon( polygon.Positions, position[0], position[2] ) )
+				return true;
+		}
+
+		return false;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetClearance
+	// Returns a distance the position can move without possibly
+	// entering or leaving any zone, 0 when next to a zone border
+	// ------------------------------------------------------------
+	float GetClearance( vector position )
+	{
+		if ( m_Columns == 0 || m_Rows == 0 )
+			return float.MAX;
+
+		int column = Math.Floor( ( position[0] - m_MinX ) / CELL_SIZE );
+		int row = Math.Floor( ( position[2] - m_MinZ ) / CELL_SIZE );
+
+		//! Outside of the grid, every zone is within the grid bounds
+		if ( column < 0 || row < 0 || column >= m_Columns || row >= m_Rows )
+		{
+			float maxX = m_MinX + m_Columns * CELL_SIZE;
+			float maxZ = m_MinZ + m_Rows * CELL_SIZE;
+
+			float dx = Math.Max( Math.Max( m_MinX - position[0], position[0] - maxX ), 0 );
+			float dz = Math.Max( Math.Max( m_MinZ - position[2], position[2] - maxZ ), 0 );
+
+			//! The grid bounds are the zone extents, so this is how far the closest zone can be
+			return Math.Sqrt( ( dx * dx ) + ( dz * dz ) );
+		}
+
+		//! A zone in this cell or a neighbouring one, must be checked every time
+		for ( int r = Math.Max( row - 1, 0 ); r <= Math.Min( row + 1, m_Rows - 1 ); ++r )
+		{
+			for ( int c = Math.Max( column - 1, 0 ); c <= Math.Min( column + 1, m_Columns - 1 ); ++c )
+			{
+				if ( m_Cells.Contains( c + r * m_Columns ) )
+					return 0;
+			}
+		}
+
+		return CELL_SIZE;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion IsInsidePolygon
+	// ------------------------------------------------------------
+	static bool IsInsidePolygon( TVectorArray positions, float x, float z )
+	{
+		bool isInside;
+
+		for ( int k = 0, l = positions.Count() - 1; k < positions.Count(); ++k )
+		{
+			if ( ( positions[k][2] > z ) != ( positions[l][2] > z ) && x < ( positions[l][0] - positions[k][0] ) * ( z - positions[k][2] ) / ( positions[l][2] - positions[k][2] ) + positions[k][0] )
+			{
+				isInside = !isInside;
+			}
+
+			l = k;
+		}
+
+		return isInside;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetCellIndex
+	// Returns -1 when the position is outside of the grid bounds
+	// ------------------------------------------------------------
+	protected int GetCellIndex( float x, float z )
+	{
+		int column = Math.Floor( ( x - m_MinX ) / CELL_SIZE );
+		int row = Math.Floor( ( z - m_MinZ ) / CELL_SIZE );
+
+		if ( column < 0 || row < 0 || column >= m_Columns || row >= m_Rows )
+			return -1;
+
+		return column + row * m_Columns;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetOrCreateCell
+	// ------------------------------------------------------------
+	protected ExpansionSafeZoneGridCell GetOrCreateCell( int index )
+	{
+		ExpansionSafeZoneGridCell cell = m_Cells.Get( index );
+		if ( !cell )
+		{
+			cell = new ExpansionSafeZoneGridCell;
+			m_Cells.Insert( index, cell );
+		}
+
+		return cell;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion AddCircle
+	// ------------------------------------------------------------
+	protected void AddCircle( int index, ExpansionSafeZoneCircle circle )
+	{
+		if ( !circle || circle.Radius <= 0 )
+			return;
+
+		float radiusSq = circle.Radius * circle.Radius;
+
+		int colStart = Math.Floor( ( circle.Center[0] - circle.Radius - m_MinX ) / CELL_SIZE );
+		int colEnd = Math.Floor( ( circle.Center[0] + circle.Radius - m_MinX ) / CELL_SIZE );
+		int rowStart = Math.Floor( ( circle.Center[2] - circle.Radius - m_MinZ ) / CELL_SIZE );
+		int rowEnd = Math.Floor( ( circle.Center[2] + circle.Radius - m_MinZ ) / CELL_SIZE );
+
+		for ( int row = Math.Max( rowStart, 0 ); row <= Math.Min( rowEnd, m_Rows - 1 ); ++row )
+		{
+			for ( int col = Math.Max( colStart, 0 ); col <= Math.Min( colEnd, m_Columns - 1 ); ++col )
+			{
+				float minX = m_MinX + col * CELL_SIZE;
+				float minZ = m_MinZ + row * CELL_SIZE;
+				float maxX = minX + CELL_SIZE;
+				float maxZ = minZ + CELL_SIZE;
+
+				//! Closest point of the cell to the center
+				float nearX = Math.Clamp( circle.Center[0], minX, maxX ) - circle.Center[0];
+				float nearZ = Math.Clamp( circle.Center[2], minZ, maxZ ) - circle.Center[2];
+				if ( ( nearX * nearX ) + ( nearZ * nearZ ) >= radiusSq )
+					continue;
+
+				ExpansionSafeZoneGridCell cell = GetOrCreateCell( col + row * m_Columns );
+				if ( cell.Inside )
+					continue;
+
+				//! Farthest corner of the cell from the center
+				float farX = Math.Max( Math.AbsFloat( minX - circle.Center[0] ), Math.AbsFloat( maxX - circle.Center[0] ) );
+				float farZ = Math.Max( Math.AbsFloat( minZ - circle.Center[2] ), Math.AbsFloat( maxZ - circle.Center[2] ) );
+				if ( ( farX * farX ) + ( farZ * farZ ) < radiusSq )
+				{
+					cell.SetInside();
+					continue;
+				}
+
+				cell.Circles.Insert( index );
+			}
+		}
+	}
+
+	// ------------------------------------------------------------
+	// Expansion AddPolygon
+	// ------------------------------------------------------------
+	protected void AddPolygon( int index, ExpansionSafeZonePolygon polygon )
+	{
+		if ( !polygon || !polygon.Positions || polygon.Positions.Count() < 3 )
+			return;
+
+		TVectorArray positions = polygon.Positions;
+		int k;
+
+		float polyMinX = float.MAX;
+		float polyMinZ = float.MAX;
+		float polyMaxX = -float.MAX;
+		float polyMaxZ = -float.MAX;
+
+		for ( k = 0; k < positions.Count(); ++k )
+		{
+			polyMinX = Math.Min( polyMinX, positions[k][0] );
+			polyMinZ = Math.Min( polyMinZ, positions[k][2] );
+			polyMaxX = Math.Max( polyMaxX, positions[k][0] );
+			polyMaxZ = Math.Max( polyMaxZ, positions[k][2] );
+		}
+
+		int colStart = Math.Floor( ( polyMinX - m_MinX ) / CELL_SIZE );
+		int colEnd = Math.Floor( ( polyMaxX - m_MinX ) / CELL_SIZE );
+		int rowStart = Math.Floor( ( polyMinZ - m_MinZ ) / CELL_SIZE );
+		int rowEnd = Math.Floor( ( polyMaxZ - m_MinZ ) / CELL_SIZE );
+
+		for ( int row = Math.Max( rowStart, 0 ); row <= Math.Min( rowEnd, m_Rows - 1 ); ++row )
+		{
+			for ( int col = Math.Max( colStart, 0 ); col <= Math.Min( colEnd, m_Columns - 1 ); ++col )
+			{
+				float minX = m_MinX + col * CELL_SIZE;
+				float minZ = m_MinZ + row * CELL_SIZE;
+				float maxX = minX + CELL_SIZE;
+				float maxZ = minZ + CELL_SIZE;
+
+				bool crossed = false;
+				for ( k = 0; k < positions.Count(); ++k )
+				{
+					vector a = positions[k];
+					vector b = positions[( k + 1 ) % positions.Count()];
+
+					if ( SegmentIntersectsCell( a[0], a[2], b[0], b[2], minX, minZ, maxX, maxZ ) )
+					{
+						crossed = true;
+						break;
+					}
+				}
+
+				//! No edge crosses the cell, so it is either fully inside or fully outside
+				if ( !crossed && !IsInsidePolygon( positions, minX + CELL_SIZE * 0.5, minZ + CELL_SIZE * 0.5 ) )
+					continue;
+
+				ExpansionSafeZoneGridCell cell = GetOrCreateCell( col + row * m_Columns );
+				if ( cell.Inside )
+					continue;
+
+				if ( !crossed )
+				{
+					cell.SetInside();
+					continue;
+				}
+
+				cell.Polygons.Insert( index );
+			}
+		}
+	}
+
+	// ------------------------------------------------------------
+	// Expansion SegmentIntersectsCell
+	// Liang-Barsky clipping of the segment against the cell bounds
+	// ------------------------------------------------------------
+	protected static bool SegmentIntersectsCell( float x0, float z0, float x1, float z1, float minX, float minZ, float maxX, float maxZ )
+	{
+		float t0 = 0.0;
+		float t1 = 1.0;
+		float dx = x1 - x0;
+		float dz = z1 - z0;
+
+		if ( !ClipEdge( -dx, x0 - minX, t0, t1 ) )
+			return false;
+		if ( !ClipEdge( dx, maxX - x0, t0, t1 ) )
+			return false;
+		if ( !ClipEdge( -dz, z0 - minZ, t0, t1 ) )
+			return false;
+		if ( !ClipEdge( dz, maxZ - z0, t0, t1 ) )
+			return false;
+
+		return true;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion ClipEdge
+	// ------------------------------------------------------------
+	protected static bool ClipEdge( float p, float q, inout float t0, inout float t1 )
+	{
+		if ( p == 0 )
+			return q >= 0;
+
+		float r = q / p;
+		if ( p < 0 )
+		{
+			if ( r > t1 )
+				return false;
+			if ( r > t0 )
+				t0 = r;
+		} else
+		{
+			if ( r < t0 )
+				return false;
+			if ( r < t1 )
+				t1 = r;
+		}
+
+		return true;
+	}
+}
@@ -10,22 +10,62 @@
  *
 */
 
+/**@class		ExpansionSafeZoneScanState
+ * @brief		Position of an entity at its last scheduled check
+ **/
+class ExpansionSafeZoneScanState
+{
+	vector LastPosition;
+	float Clearance;
+}
+
 /**@class		ExpansionSafeZoneModule
  * @brief		
  **/
 class ExpansionSafeZoneModule: JMModuleBase
 {
+	//! Lowest interval between two scheduled checks, 0 would never yield
+	static const int MIN_SCHEDULED_CHECK_INTERVAL = 10;
+
 	private autoptr ExpansionSafeZoneSettings m_Settings;
+	private autoptr ExpansionSafeZoneGrid m_Grid;
+
+	private int m_ScanCursor;
+	private autoptr map< Object, ref ExpansionSafeZoneScanState > m_ScanStates;
+	private autoptr map< Object, ref ExpansionSafeZoneScanState > m_ScanStatesNext;
+
+	void ExpansionSafeZoneModule()
+	{
+		m_Grid = new ExpansionSafeZoneGrid;
+
+		m_ScanStates = new map< Object, ref ExpansionSafeZoneScanState >;
+		m_ScanStatesNext = new map< Object, ref ExpansionSafeZoneScanState >;
+	}
 
 	override void OnMissionLoaded()
 	{
 		super.OnMissionLoaded();
 
 		m_Settings = GetExpansionSettings().GetSafeZone();
+		m_Grid.Build( m_Settings );
 
 		GetGame().GameScript.Call( this, "ThreadSafeZone", NULL );
 	}
 
+	override void OnSettingsUpdated()
+	{
+		super.OnSettingsUpdated();
+
+		if ( !m_Settings )
+			return;
+
+		m_Grid.Build( m_Settings );
+
+		//! Zones changed, every entity has to be checked again
+		m_ScanStates.Clear();
+		m_ScanStatesNext.Clear();
+	}
+
 	override bool IsClient()
 	{
 		return false;
@@ -35,86 +75,67 @@ class ExpansionSafeZoneModule: JMModuleBase
 	{
 		if ( m_Settings.Enabled )
 		{
-			bool isInsideCircleZone;
-			bool isInsidePolygonZone;
-			int j;
-			int p;
-
-			IsInsideSafeZone( position, isInsideCircleZone, isInsidePolygonZone, j, p );
-
-			return isInsideCircleZone || isInsidePolygonZone;
+			return m_Grid.IsInside( position );
 		}
 
 		return false;
 	}
 
-	// ------------------------------------------------------------
-	// Expansion IsInsideSafeZone
-	// ------------------------------------------------------------
-	private void IsInsideSafeZone( vector pos_obj, out bool isInsideCircleZone = false, out bool isInsidePolygonZone = false, out int j = 0, out int p = 0)
-	{	
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionSafeZoneModule:: IsInsideSafeZone - Start");
-		#endif
-		
-		array<ref ExpansionSafeZoneCircle> circleZones = m_Settings.CircleZones;
-		array<ref ExpansionSafeZonePolygon> polygonZones = m_Settings.PolygonZones;
-
-		if ( !circleZones || !polygonZones )
-			return;
-
-		//Check all circle zone first, because it's not heavy on perf than polygon check
-		for ( j = 0; j < circleZones.Count(); j++)
+	private void CheckPlayer( PlayerBase player )
+	{
+		bool isInside = IsInside( player.GetPosition() );
+			
+		if ( isInside )
 		{
-			ExpansionSafeZoneCircle circleZone = circleZones[j];
-
-			if ( !circleZone )
-				continue;
-									
-			float xPower = circleZone.Center[0] - pos_obj[0];
-			float zPower = circleZone.Center[2] - pos_obj[2];
-
-			float distance_squared = ( xPower * xPower ) + ( zPower * zPower ); 
-				
-			if ( distance_squared < (circleZone.Radius * circleZone.Radius) ) 
+			if ( !player.IsInSafeZone() )
 			{
-				isInsideCircleZone = true;
-				return;
+				player.OnEnterSafeZone();
+			}
+		} else 
+		{
+			if ( player.IsInSafeZone() )
+			{
+				player.OnLeftSafeZone();
 			}
 		}
+	}
 
-		// If he are not inside circle zone we check polygon zone, more heavy on performance
-		if ( !isInsideCircleZone )
+	private void CheckZombie( ZombieBase zombie )
+	{
+		bool isInside = IsInside( zombie.GetPosition() );
+			
+		if ( isInside )
 		{
-			for ( p = 0; p < polygonZones.Count(); p++ )
+			if ( !zombie.IsInSafeZone() )
 			{
-				ExpansionSafeZonePolygon polyZone = polygonZones[p];
-
-				if ( !polyZone )
-					continue;
-
-				ref TVectorArray polygonPosition = polyZone.Positions;
-					
-				for ( int k = 0, l = polygonPosition.Count() - 1; k < polygonPosition.Count(); ++k)
-				{
-					if ( ( polygonPosition[k][2] > pos_obj[2] ) != ( polygonPosition[l][2] > pos_obj[2] ) && pos_obj[0] < ( polygonPosition[l][0] - polygonPosition[k][0] ) * ( pos_obj[2] - polygonPosition[k][2] ) / ( polygonPosition[l][2] - polygonPosition[k][2] ) + polygonPosition[k][0] )
-					{
-						isInsidePolygonZone = !isInsidePolygonZone;
-					}
-
-					l = k;
-				}
+				zombie.OnEnterSafeZone();
+			}
+		} else 
+		{
+			if ( zombie.IsInSafeZone() )
+			{
+				zombie.OnLeftSafeZone();
+			}
+		}
+	}
 
-				if ( isInsidePolygonZone )
-				{
-					return;
-				}
+	private void CheckVehicle( CarScript vehicle )
+	{
+		bool isInside = IsInside( vehicle.GetPosition() );
+			
+		if ( isInside )
+		{
+			if ( !vehicle.IsInSafeZone() )
+			{
+				vehicle.OnEnterSafeZone();
+			}
+		} else 
+		{
+			if ( vehicle.IsInSafeZone() )
+			{
+				vehicle.OnLeftSafeZone();
 			}
 		}
-		
-		#ifdef EXPANSIONEXPRINT
-		EXPrint("ExpansionSafeZoneModule:: IsInsideSafeZone - End");
-		#endif
 	}
 
 	private void CheckPlayers()
@@ -127,21 +148,7 @@ class ExpansionSafeZoneModule: JMModuleBase
 			if ( !player )
 				continue;
 
-			bool isInside = IsInside( player.GetPosition() );
-				
-			if ( isInside )
-			{
-				if ( !player.IsInSafeZone() )
-				{
-					player.OnEnterSafeZone();
-				}
-			} else 
-			{
-				if ( player.IsInSafeZone() )
-				{
-					player.OnLeftSafeZone();
-				}
-			}
+			CheckPlayer( player );
 		}
 	}
 
@@ -153,21 +160,7 @@ class ExpansionSafeZoneModule: JMModuleBase
 			if ( !zombie )
 				continue;
 
-			bool isInside = IsInside( zombie.GetPosition() );
-				
-			if ( isInside )
-			{
-				if ( !zombie.IsInSafeZone() )
-				{
-					zombie.OnEnterSafeZone();
-				}
-			} else 
-			{
-				if ( zombie.IsInSafeZone() )
-				{
-					zombie.OnLeftSafeZone();
-				}
-			}
+			CheckZombie( zombie );
 		}
 	}
 
@@ -179,20 +172,105 @@ class ExpansionSafeZoneModule: JMModuleBase
 			if ( !vehicle )
 				continue;
 
-			bool isInside = IsInside( vehicle.GetPosition() );
-				
-			if ( isInside )
+			CheckVehicle( vehicle );
+		}
+	}
+
+	// ------------------------------------------------------------
+	// Expansion NeedsCheck
+	// Skips entities which did not move far enough since their last
+	// check to possibly cross a zone border
+	// ------------------------------------------------------------
+	private bool NeedsCheck( Object entity )
+	{
+		vector position = entity.GetPosition();
+
+		ExpansionSafeZoneScanState state = m_ScanStatesNext.Get( entity );
+		if ( !state )
+		{
+			state = m_ScanStates.Get( entity );
+			if ( state )
+				m_ScanStatesNext.Insert( entity, state );
+		}
+
+		if ( state )
+		{
+			if ( vector.DistanceSq( position, state.LastPosition ) < state.Clearance * state.Clearance )
+				return false;
+		} else
+		{
+			state = new ExpansionSafeZoneScanState;
+			m_ScanStatesNext.Insert( entity, state );
+		}
+
+		state.LastPosition = position;
+		state.Clearance = Math.Max( m_Grid.GetClearance( position ), m_Settings.MinMovementDistanceCheck );
+
+		return true;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion CheckScheduled
+	// Round-robin over players, infected and vehicles, checking at
+	// most EntitiesCheckedPerTick entities per call
+	// ------------------------------------------------------------
+	private void CheckScheduled()
+	{
+		array< PlayerBase > players = PlayerBase.GetAll();
+		set< ZombieBase > zombies = ZombieBase.GetAll();
+		set< CarScript > vehicles = CarScript.GetAll();
+
+		int playerCount = players.Count();
+		int zombieCount = zombies.Count();
+		int total = playerCount + zombieCount + vehicles.Count();
+
+		int checkedCount = 0;
+
+		for ( int visited = 0; visited < total && checkedCount < m_Settings.EntitiesCheckedPerTick; ++visited )
+		{
+			if ( m_ScanCursor >= total )
 			{
-				if ( !vehicle.IsInSafeZone() )
+				//! Full pass done, forget the entities which were not seen during it
+				m_ScanCursor = 0;
+				m_ScanStates = m_ScanStatesNext;
+				m_ScanStatesNext = new map< Object, ref ExpansionSafeZoneScanState >;
+			}
+
+			int index = m_ScanCursor++;
+
+			if ( index < playerCount )
+			{
+				PlayerBase player = players[index];
+				if ( player && NeedsCheck( player ) )
 				{
-					vehicle.OnEnterSafeZone();
+					CheckPlayer( player );
+					checkedCount++;
 				}
-			} else 
+
+				continue;
+			}
+
+			index -= playerCount;
+
+			if ( index < zombieCount )
 			{
-				if ( vehicle.IsInSafeZone() )
+				ZombieBase zombie = zombies.Get( index );
+				if ( zombie && NeedsCheck( zombie ) )
 				{
-					vehicle.OnLeftSafeZone();
+					CheckZombie( zombie );
+					checkedCount++;
 				}
+
+				continue;
+			}
+
+			index -= zombieCount;
+
+			CarScript vehicle = vehicles.Get( index );
+			if ( vehicle && NeedsCheck( vehicle ) )
+			{
+				CheckVehicle( vehicle );
+				checkedCount++;
 			}
 		}
 	}
@@ -229,6 +307,22 @@ class ExpansionSafeZoneModule: JMModuleBase
 				return;
 			}
 
+			if ( m_Settings.EntitiesCheckedPerTick > 0 )
+			{
+				CheckScheduled();
+
+				#ifdef EXPANSIONEXPRINT
+				EXPrint("ExpansionSafeZoneModule:: ThreadSafeZone - End (Scheduled)");
+				#endif
+
+				int interval = m_Settings.ScheduledCheckSafeZoneInMs;
+				if ( interval < MIN_SCHEDULED_CHECK_INTERVAL )
+					interval = MIN_SCHEDULED_CHECK_INTERVAL;
+
+				Sleep( interval );
+				continue;
+			}
+
 			CheckPlayers();
 			CheckZombies();
 			CheckVehicles();
@@ -0,0 +1,159 @@
+/**
+ * ExpansionTerritoryFlagGrid.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2020 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionTerritoryFlagGrid
+ * @brief		2D spatial hash of the territory flags, keyed by cell on the XZ plane.
+ *				Stores territory IDs and the flag position they were added with,
+ *				so entries can still be removed once the flag object is gone.
+ **/
+class ExpansionTerritoryFlagGrid
+{
+	protected float m_CellSize;
+
+	protected autoptr map< int, ref array< int > > m_Cells;
+	protected autoptr map< int, vector > m_Positions;
+
+	// ------------------------------------------------------------
+	// Expansion ExpansionTerritoryFlagGrid
+	// ------------------------------------------------------------
+	void ExpansionTerritoryFlagGrid( float cellSize )
+	{
+		m_CellSize = Math.Max( cellSize, 1.0 );
+
+		m_Cells = new map< int, ref array< int > >;
+		m_Positions = new map< int, vector >;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetCellSize
+	// ------------------------------------------------------------
+	float GetCellSize()
+	{
+		return m_CellSize;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetCellKey
+	// ------------------------------------------------------------
+	protected int GetCellKey( int column, int row )
+	{
+		return column * 65536 + row;
+	}
+
+	// ------------------------------------------------------------
+	// Expansion Add
+	// ------------------------------------------------------------
+	void Add( int territoryID, vector position )
+	{
+		if ( m_Positions.Contains( territoryID ) )
+			Remove( territoryID );
+
+		int key = GetCellKey( Math.Floor( position[0] / m_CellSize ), Math.Floor( position[2] / m_CellSize ) );
+
+		array< int > cell;
+		if ( !m_Cells.Find( key, cell ) )
+		{
+			cell = new array< int >;
+			m_Cells.Insert( key, cell );
+		}
+
+		cell.Insert( territoryID );
+		m_Positions.Insert( territoryID, position );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion Remove
+	// ------------------------------------------------------------
+	void Remove( int territoryID )
+	{
+		vector position;
+		if ( !m_Positions.Find( territoryID, position ) )
+			return;
+
+		m_Positions.Remove( territoryID );
+
+		int key = GetCellKey( Math.Floor( position[0] / m_CellSize ), Math.Floor( position[2] / m_CellSize ) );
+
+		array< int > cell;
+		if ( !m_Cells.Find( key, cell ) )
+			return;
+
+		cell.RemoveItem( territoryID );
+
+		if ( cell.Count() == 0 )
+			m_Cells.Remove( key );
+	}
+
+	// ------------------------------------------------------------
+	// Expansion Clear
+	// ------------------------------------------------------------
+	void Clear()
+	{
+		m_Cells.Clear();
+		m_Positions.Clear();
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetInRadius
+	// Appends the IDs of every flag within radius of the position
+	// ------------------------------------------------------------
+	void GetInRadius( vector position, float radius, notnull array< int > territoryIDs )
+	{
+		float radiusSq = radius * radius;
+
+		int minColumn = Math.Floor( ( position[0] - radius ) / m_CellSize );
+		int maxColumn = Math.Floor( ( position[0] + radius ) / m_CellSize );
+		int minRow = Math.Floor( ( position[2] - radius ) / m_CellSize );
+		int maxRow = Math.Floor( ( position[2] + radius ) / m_CellSize );
+
+		for ( int column = minColumn; column <= maxColumn; ++column )
+		{
+			for ( int row = minRow; row <= maxRow; ++row )
+			{
+				array< int > cell;
+				if ( !m_Cells.Find( GetCellKey( column, row ), cell ) )
+					continue;
+
+				for ( int i = 0; i < cell.Count(); ++i )
+				{
+					if ( vector.DistanceSq( m_Positions.Get( cell[i] ), position ) <= radiusSq )
+						territoryIDs.Insert( cell[i] );
+				}
+			}
+		}
+	}
+
+	// ------------------------------------------------------------
+	// Expansion GetNearest
+	// Returns the ID of the nearest flag within radius, -1 if none
+	// ------------------------------------------------------------
+	int GetNearest( vector position, float radius )
+	{
+		array< int > territoryIDs = new array< int >;
+		GetInRadius( position, radius, territoryIDs );
+
+		int nearest = -1;
+		float nearestDistSq = float.MAX;
+
+		for ( int i = 0; i < territoryIDs.Count(); ++i )
+		{
+			float distSq = vector.DistanceSq( m_Positions.Get( territoryIDs[i] ), position );
+			if ( distSq < nearestDistSq )
+			{
+				nearest = territoryIDs[i];
+				nearestDistSq = distSq;
+			}
+		}
+
+		return nearest;
+	}
+}
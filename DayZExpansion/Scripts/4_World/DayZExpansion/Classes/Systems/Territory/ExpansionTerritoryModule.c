@@ -17,13 +17,18 @@ class ExpansionTerritoryModule: JMModuleBase
 	static const int 									m_TerritorySize_Level_2 = 100;
 	static const int 									m_TerritorySize_Level_3 = 150;
 	static const int 									m_TerritorySize_MAX = 150;
+
+	static const float									CHECK_PLAYERS_INTERVAL = 2.5;
 	
 	/////////////////////// NON STATIC VARS ///////////////////////////////
 	
 	//Server
 	protected autoptr map<int, ExpansionTerritoryFlag> 		m_TerritoryFlags;
+	protected autoptr ExpansionTerritoryFlagGrid			m_TerritoryFlagGrid;
+	protected autoptr map<string, ref TIntArray>			m_PlayerTerritories;
 	protected int 											m_NextTerritoryID;
 	protected float											m_TimeSliceCheckPlayer;
+	protected int											m_CheckPlayerCursor;
 	
 	//Client
 	protected autoptr map<int, ref ExpansionTerritory>		m_Territories;
@@ -43,8 +48,10 @@ class ExpansionTerritoryModule: JMModuleBase
 			
 		//Server	
 		m_TerritoryFlags = new map<int, ExpansionTerritoryFlag>;
+		m_PlayerTerritories = new map<string, ref TIntArray>;
 		m_NextTerritoryID = 0;
 		m_TimeSliceCheckPlayer = 0;
+		m_CheckPlayerCursor = 0;
 		
 		//Client	
 		m_Territories = new map<int, ref ExpansionTerritory>;
@@ -88,39 +95,18 @@ class ExpansionTerritoryModule: JMModuleBase
 		EXLogPrint("ExpansionTerritoryModule::OnPlayerConnect - Start uid : " + uid + " m_TerritoryFlags.Count() : " + m_TerritoryFlags.Count());
 		#endif
 		
-		TIntArray toRemove = new TIntArray;
+		TIntArray territoryIDs = GetPlayerTerritoryIDs( uid );
 		
-		for(int i = 0; i < m_TerritoryFlags.Count(); ++i)
+		for(int i = 0; i < territoryIDs.Count(); ++i)
 		{
-			ExpansionTerritoryFlag currFlag = m_TerritoryFlags.GetElement(i);
-			if (!currFlag)
-			{
-				toRemove.Insert(m_TerritoryFlags.GetKey(i));
-				continue;
-			}
-			
-			ExpansionTerritory territory = currFlag.GetTerritory();
-			if ( !territory )
-				continue;
+			ExpansionTerritory territory = m_TerritoryFlags.Get( territoryIDs[i] ).GetTerritory();
 
 			#ifdef EXPANSIONEXLOGPRINT
-			EXLogPrint("ExpansionTerritoryModule::OnPlayerConnect Current territory : " + territory.GetTerritoryName());
+			EXLogPrint("ExpansionTerritoryModule::OnPlayerConnect Found territory : " + territory.GetTerritoryName());
 			#endif
 
-			if ( territory && territory.IsMember( uid ) )
-			{
-				#ifdef EXPANSIONEXLOGPRINT
-				EXLogPrint("ExpansionTerritoryModule::OnPlayerConnect Found territory : " + territory.GetTerritoryName());
-				#endif
-
-				UpdateClient( territory.GetTerritoryID() );
-				UpdateClient( territory.GetTerritoryID(), player );
-			}
-		}
-		
-		for (int j = 0; j < toRemove.Count(); ++j)
-		{
-			m_TerritoryFlags.Remove( toRemove[j] );
+			UpdateClient( territory.GetTerritoryID() );
+			UpdateClient( territory.GetTerritoryID(), player );
 		}
 		
 		//Sync invites
@@ -134,16 +120,34 @@ class ExpansionTerritoryModule: JMModuleBase
 	// ------------------------------------------------------------
 	// Override OnUpdate
 	// ------------------------------------------------------------
+	//! Every player gets checked once per CHECK_PLAYERS_INTERVAL seconds, spread over the updates in between
 	override void OnUpdate( float timeslice )
 	{
-		if ( !IsMissionClient() )
+		if ( !IsMissionHost() )
 			return;
-			
+
 		m_TimeSliceCheckPlayer += timeslice;
-		
-		if ( m_TimeSliceCheckPlayer > 2.5 )
+
+		array< PlayerBase > players = PlayerBase.GetAll();
+		int playerCount = players.Count();
+		if ( playerCount == 0 )
+		{
+			m_CheckPlayerCursor = 0;
+			m_TimeSliceCheckPlayer = 0;
+			return;
+		}
+
+		//! Number of players which should have been checked by now in the current pass
+		int due = Math.Ceil( playerCount * Math.Min( m_TimeSliceCheckPlayer / CHECK_PLAYERS_INTERVAL, 1 ) );
+
+		while ( m_CheckPlayerCursor < due && m_CheckPlayerCursor < playerCount )
+		{
+			CheckPlayer( players[m_CheckPlayerCursor++] );
+		}
+
+		if ( m_TimeSliceCheckPlayer >= CHECK_PLAYERS_INTERVAL )
 		{
-			Exec_CheckPlayer();
+			m_CheckPlayerCursor = 0;
 			m_TimeSliceCheckPlayer = 0;
 		}
 	}
@@ -281,13 +285,6 @@ class ExpansionTerritoryModule: JMModuleBase
 			EXLogPrint("ExpansionTerritoryModule::OnRPC - RPC_Leave");
 			#endif
 
-			break;
-		case ExpansionTerritoryModuleRPC.PlayerEnteredTerritory:
-			RPC_PlayerEnteredTerritory( ctx, sender, target );
-			#ifdef EXPANSIONEXLOGPRINT
-			EXLogPrint("ExpansionTerritoryModule::OnRPC - RPC_DeleteObject");
-			#endif
-
 			break;
 		}
 		
@@ -540,11 +537,11 @@ class ExpansionTerritoryModule: JMModuleBase
 		
 		territoryFlag.SetTerritory( newTerritory );
 		
-		m_TerritoryFlags.Insert( m_NextTerritoryID, territoryFlag );
-		
-		UpdateClient( m_NextTerritoryID );
+		//! Also advances m_NextTerritoryID
+		int territoryID = m_NextTerritoryID;
+		AddTerritoryFlag( territoryFlag, territoryID );
 		
-		m_NextTerritoryID++;
+		UpdateClient( territoryID );
 		
 		GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_TERRITORY_TITLE" ), new StringLocaliser( "STR_EXPANSION_TERRITORY_CREATED", territoryName ), EXPANSION_NOTIFICATION_ICON_TERRITORY, COLOR_EXPANSION_NOTIFICATION_SUCCSESS, 5, sender );
 		
@@ -724,15 +721,18 @@ class ExpansionTerritoryModule: JMModuleBase
 				SyncPlayersInvites(currPlayerInvite);
 			}
 			
+			//! The owner is a member too, so everyone hears about it from the same batch
+			NotifyTerritoryDeleted( currentTerritory, "" );
+
+			RemoveTerritoryMemberships( currentTerritory );
+
 			//Don't forget to set it as null before to delete, to not do a infinte loop
 			flag.SetTerritory(null);
 
 			GetGame().CreateObject( "ExpansionFlagKitExpansion", flag.GetPosition() );
 			flag.Delete();
 			
-			m_TerritoryFlags.Remove( territoryID );
-			
-			GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_TERRITORY_TITLE" ), new StringLocaliser( "STR_EXPANSION_TERRITORY_DELETED", currentTerritory.GetTerritoryName() ), EXPANSION_NOTIFICATION_ICON_INFO, COLOR_EXPANSION_NOTIFICATION_ORANGEVILLE, 5, sender );
+			RemoveTerritoryFlag( territoryID );
 		} else
 		{
 			//TODO: message
@@ -837,12 +837,20 @@ class ExpansionTerritoryModule: JMModuleBase
 			SyncPlayersInvites(currPlayerInvite);
 		}
 		
+		string senderUID;
+		if ( sender )
+			senderUID = sender.GetId();
+
+		NotifyTerritoryDeleted( currentTerritory, senderUID );
+
+		RemoveTerritoryMemberships( currentTerritory );
+
 		//Don't forget to set it as null before to delete, to not do a infinte loop
 		flag.SetTerritory( null );
 		if (!flag.ToDelete())
 			flag.Delete();
 		
-		m_TerritoryFlags.Remove( territoryID );
+		RemoveTerritoryFlag( territoryID );
 		
 		if (sender)
 			GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_TERRITORY_TITLE" ), new StringLocaliser( "STR_EXPANSION_TERRITORY_DELETED", currentTerritory.GetTerritoryName() ), EXPANSION_NOTIFICATION_ICON_INFO, COLOR_EXPANSION_NOTIFICATION_ORANGEVILLE, 5, sender );
@@ -1129,6 +1137,7 @@ class ExpansionTerritoryModule: JMModuleBase
 		
 		territory.RemoveTerritoryInvite( sender.GetId() );
 		territory.AddMember( sender.GetId(), sender.GetName() );
+		AddPlayerTerritory( sender.GetId(), territoryID );
 		
 		SyncPlayersInvites( senderPlayer );
 		UpdateClient( territoryID );
@@ -1485,6 +1494,7 @@ class ExpansionTerritoryModule: JMModuleBase
 		}
 		
 		territory.RemoveMember( target );
+		RemovePlayerTerritory( target.GetID(), territoryID );
 		
 		PlayerBase playerTarget = PlayerBase.GetPlayerByUID( target.GetID() );
 		if (playerTarget)
@@ -1576,6 +1586,7 @@ class ExpansionTerritoryModule: JMModuleBase
 		}
 		
 		territory.RemoveMember( senderTerritory );
+		RemovePlayerTerritory( sender.GetId(), territoryID );
 		
 		Send_UpdateClient( territoryID, NULL, sender );
 		
@@ -1590,96 +1601,70 @@ class ExpansionTerritoryModule: JMModuleBase
 	}
 	
 	// ------------------------------------------------------------
-	// ExpansionTerritoryModule RPC_PlayerEnteredTerritory
+	// ExpansionTerritoryModule CheckPlayer
 	// Called on server
+	// Check if player entered or left a territory, if so, send a notification
 	// ------------------------------------------------------------
-	private void RPC_PlayerEnteredTerritory( ref ParamsReadContext ctx, PlayerIdentity senderRPC, Object target )
+	private void CheckPlayer( PlayerBase player )
 	{
-		#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionTerritoryModule::RPC_PlayerEnteredTerritory - Start");
-		#endif
-		
-		int type;
-		if ( !ctx.Read( type ) )
-			return;
-		
-		int territoryID
-		if ( !ctx.Read( territoryID ) )
+		if ( !player || !player.GetIdentity() )
 			return;
 
-		ExpansionTerritoryFlag flag = m_TerritoryFlags.Get( territoryID );
-		if ( !flag )
-			return;
-		
-		ExpansionTerritory territory = flag.GetTerritory();
-		if ( !territory )
+		int previousID = player.GetTerritoryIDInside();
+
+		int territoryID = GetTerritoryFlagGrid().GetNearest( player.GetPosition(), GetExpansionSettings().GetTerritory().TerritorySize );
+		if ( territoryID == previousID )
 			return;
 
-		if ( type == 0 )
+		#ifdef EXPANSIONEXLOGPRINT
+		EXLogPrint("ExpansionTerritoryModule::CheckPlayer - " + player.GetIdentityUID() + " moved from territory " + previousID + " to " + territoryID);
+		#endif
+
+		player.SetTerritoryIDInside( territoryID );
+
+		if ( territoryID > -1 )
 		{
-			GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_TERRITORY_TITLE" ), new StringLocaliser( "STR_EXPANSION_TERRITORY_ENTER_TERRITORY", territory.GetTerritoryName() ), EXPANSION_NOTIFICATION_ICON_TERRITORY, COLOR_EXPANSION_NOTIFICATION_ORANGEVILLE, 5, senderRPC );	
-			return;
+			OnPlayerEnteredTerritory( player, territoryID );
 		}
-		else if ( type == 1 )
+		else
 		{
-			GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_TERRITORY_TITLE" ), new StringLocaliser( "STR_EXPANSION_TERRITORY_LEFT_TERRITORY", territory.GetTerritoryName() ), EXPANSION_NOTIFICATION_ICON_TERRITORY, COLOR_EXPANSION_NOTIFICATION_ORANGEVILLE, 5, senderRPC );
-			return;
+			OnPlayerLeftTerritory( player, previousID );
 		}
-		
-		#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionTerritoryModule::RPC_PlayerEnteredTerritory - End");
-		#endif
 	}
 
 	// ------------------------------------------------------------
-	// ExpansionTerritoryModule Exec_CheckPlayer
-	// Called on client
-	// Check if player is inside territory, if so, send a notification
+	// ExpansionTerritoryModule OnPlayerEnteredTerritory
+	// Called on server
 	// ------------------------------------------------------------
-	private void Exec_CheckPlayer()
+	protected void OnPlayerEnteredTerritory( PlayerBase player, int territoryID )
 	{
-		PlayerBase player;
-		if ( !Class.CastTo( player, GetGame().GetPlayer() ) )
+		ExpansionTerritoryFlag flag = m_TerritoryFlags.Get( territoryID );
+		if ( !flag )
 			return;
 
-		#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionTerritoryModule::Exec_CheckPlayer - Start");
-		#endif
-		
-		ExpansionTerritoryFlag flag = FindNearestTerritoryFlag( player );
+		ExpansionTerritory territory = flag.GetTerritory();
+		if ( !territory )
+			return;
 
-		int type = -1;
-		int territoryId;
-		if ( flag )
-		{
-			territoryId = flag.GetTerritoryID();
-			if ( territoryId != player.GetTerritoryIDInside() )
-			{
-				type = 0;
-				player.SetTerritoryIDInside( territoryId );
-			}
-		}
-		else
-		{
-			if ( player.GetTerritoryIDInside() != -1 )
-				type = 1;
+		GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_TERRITORY_TITLE" ), new StringLocaliser( "STR_EXPANSION_TERRITORY_ENTER_TERRITORY", territory.GetTerritoryName() ), EXPANSION_NOTIFICATION_ICON_TERRITORY, COLOR_EXPANSION_NOTIFICATION_ORANGEVILLE, 5, player.GetIdentity() );
+	}
 
-			territoryId = player.GetTerritoryIDInside();
+	// ------------------------------------------------------------
+	// ExpansionTerritoryModule OnPlayerLeftTerritory
+	// Called on server
+	// ------------------------------------------------------------
+	protected void OnPlayerLeftTerritory( PlayerBase player, int territoryID )
+	{
+		//! Territory might have been deleted while the player was inside
+		ExpansionTerritoryFlag flag = m_TerritoryFlags.Get( territoryID );
+		if ( !flag )
+			return;
 
-			player.SetTerritoryIDInside( -1 );
-		}
+		ExpansionTerritory territory = flag.GetTerritory();
+		if ( !territory )
+			return;
 
-		if ( type > -1 )
-		{
-			ScriptRPC rpc = new ScriptRPC();
-			rpc.Write( type );
-			rpc.Write( territoryId );
- 			rpc.Send( null, ExpansionTerritoryModuleRPC.PlayerEnteredTerritory, true );
-		}
-		
-		#ifdef EXPANSIONEXLOGPRINT
-		EXLogPrint("ExpansionTerritoryModule::Exec_CheckPlayer - End");
-		#endif
+		GetNotificationSystem().CreateNotification( new StringLocaliser( "STR_EXPANSION_TERRITORY_TITLE" ), new StringLocaliser( "STR_EXPANSION_TERRITORY_LEFT_TERRITORY", territory.GetTerritoryName() ), EXPANSION_NOTIFICATION_ICON_TERRITORY, COLOR_EXPANSION_NOTIFICATION_ORANGEVILLE, 5, player.GetIdentity() );
 	}
 	
 	///////////////////////// RequestServerTerritories /////////////////////////////////
@@ -1782,20 +1767,14 @@ class ExpansionTerritoryModule: JMModuleBase
 	// ------------------------------------------------------------
 	bool IsPlayerInsideTerritory( notnull PlayerIdentity identity )
 	{
+		if ( IsMissionHost() )
+			return GetPlayerTerritoryIDs( identity.GetId() ).Count() > 0;
+
 		for ( int i = 0; i < m_Territories.Count(); i++ )
 	    {
-			ExpansionTerritory currentTerritory = ExpansionTerritory.Cast( m_Territories.Get(i) );
-			array<ref ExpansionTerritoryMember> territoryMembers = currentTerritory.GetTerritoryMembers();
-			
-			for ( int j = 0; j < territoryMembers.Count(); j++ )
-	    	{
-				ExpansionTerritoryMember currentMember = ExpansionTerritoryMember.Cast( territoryMembers.Get(j) );
-				
-				if ( currentMember && currentMember.GetID() == identity.GetPlainId() )
-				{
-					return true;
-				}
-			}
+			ExpansionTerritory currentTerritory = m_Territories.GetElement( i );
+			if ( currentTerritory && currentTerritory.IsMember( identity.GetId() ) )
+				return true;
 		}
 
 		return false;
@@ -1810,6 +1789,16 @@ class ExpansionTerritoryModule: JMModuleBase
 			return null;
 		
 		vector position = player.GetPosition();
+
+		if ( IsMissionHost() )
+		{
+			int territoryID = GetTerritoryFlagGrid().GetNearest( position, GetExpansionSettings().GetTerritory().TerritorySize );
+			if ( territoryID < 0 )
+				return null;
+
+			return m_TerritoryFlags.Get( territoryID );
+		}
+
 		array<Object> objects = new array<Object>;
 		array<CargoBase> proxyCargos = new array<CargoBase> ;
 		GetGame().GetObjectsAtPosition3D( position, GetExpansionSettings().GetTerritory().TerritorySize, objects, proxyCargos );
@@ -1839,6 +1828,17 @@ class ExpansionTerritoryModule: JMModuleBase
 			return;
 		
 		m_TerritoryFlags.Insert( territoryID, flag );
+		GetTerritoryFlagGrid().Add( territoryID, flag.GetPosition() );
+
+		if ( flag.GetTerritory() )
+		{
+			array< ref ExpansionTerritoryMember > members = flag.GetTerritory().GetTerritoryMembers();
+			for ( int i = 0; i < members.Count(); ++i )
+			{
+				if ( members[i] )
+					AddPlayerTerritory( members[i].GetID(), territoryID );
+			}
+		}
 		
 		if ( m_NextTerritoryID <= territoryID )
 		{
@@ -1859,6 +1859,122 @@ class ExpansionTerritoryModule: JMModuleBase
 			return;
 		
 		m_TerritoryFlags.Remove( territoryID );
+
+		if ( m_TerritoryFlagGrid )
+			m_TerritoryFlagGrid.Remove( territoryID );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionTerritoryModule GetPlayerTerritoryIDs
+	// Called on server
+	// Returns the IDs of the territories the player is a member of.
+	// Entries whose flag or membership is gone are pruned on the way.
+	// ------------------------------------------------------------
+	TIntArray GetPlayerTerritoryIDs( string uid )
+	{
+		TIntArray territoryIDs = new TIntArray;
+
+		TIntArray indexed;
+		if ( !m_PlayerTerritories.Find( uid, indexed ) )
+			return territoryIDs;
+
+		for ( int i = indexed.Count() - 1; i >= 0; --i )
+		{
+			ExpansionTerritoryFlag flag = m_TerritoryFlags.Get( indexed[i] );
+			if ( !flag )
+			{
+				RemoveTerritoryFlag( indexed[i] );
+				indexed.Remove( i );
+				continue;
+			}
+
+			ExpansionTerritory territory = flag.GetTerritory();
+			if ( !territory || !territory.IsMember( uid ) )
+			{
+				indexed.Remove( i );
+				continue;
+			}
+
+			territoryIDs.Insert( indexed[i] );
+		}
+
+		if ( indexed.Count() == 0 )
+			m_PlayerTerritories.Remove( uid );
+
+		return territoryIDs;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionTerritoryModule AddPlayerTerritory
+	// Called on server
+	// ------------------------------------------------------------
+	protected void AddPlayerTerritory( string uid, int territoryID )
+	{
+		TIntArray territoryIDs;
+		if ( !m_PlayerTerritories.Find( uid, territoryIDs ) )
+		{
+			territoryIDs = new TIntArray;
+			m_PlayerTerritories.Insert( uid, territoryIDs );
+		}
+
+		if ( territoryIDs.Find( territoryID ) == -1 )
+			territoryIDs.Insert( territoryID );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionTerritoryModule RemovePlayerTerritory
+	// Called on server
+	// ------------------------------------------------------------
+	protected void RemovePlayerTerritory( string uid, int territoryID )
+	{
+		TIntArray territoryIDs;
+		if ( !m_PlayerTerritories.Find( uid, territoryIDs ) )
+			return;
+
+		territoryIDs.RemoveItem( territoryID );
+
+		if ( territoryIDs.Count() == 0 )
+			m_PlayerTerritories.Remove( uid );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionTerritoryModule RemoveTerritoryMemberships
+	// Called on server when a territory gets deleted
+	// ------------------------------------------------------------
+	protected void RemoveTerritoryMemberships( ExpansionTerritory territory )
+	{
+		array< ref ExpansionTerritoryMember > members = territory.GetTerritoryMembers();
+		for ( int i = 0; i < members.Count(); ++i )
+		{
+			if ( members[i] )
+				RemovePlayerTerritory( members[i].GetID(), territory.GetTerritoryID() );
+		}
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionTerritoryModule NotifyTerritoryDeleted
+	// Called on server, before the memberships are removed
+	// ------------------------------------------------------------
+	protected void NotifyTerritoryDeleted( ExpansionTerritory territory, string excludeUID )
+	{
+		ExpansionNotificationModule notificationModule;
+		if ( !Class.CastTo( notificationModule, GetModuleManager().GetModule( ExpansionNotificationModule ) ) )
+			return;
+
+		notificationModule.NotifyTerritory( new StringLocaliser( "STR_EXPANSION_TERRITORY_TITLE" ), new StringLocaliser( "STR_EXPANSION_TERRITORY_DELETED", territory.GetTerritoryName() ), EXPANSION_NOTIFICATION_ICON_INFO, COLOR_EXPANSION_NOTIFICATION_ORANGEVILLE, 5, territory, excludeUID );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionTerritoryModule GetTerritoryFlagGrid
+	// Called on server
+	// Spatial index of m_TerritoryFlags, the cell size is the territory size
+	// ------------------------------------------------------------
+	protected ExpansionTerritoryFlagGrid GetTerritoryFlagGrid()
+	{
+		if ( !m_TerritoryFlagGrid )
+			m_TerritoryFlagGrid = new ExpansionTerritoryFlagGrid( GetExpansionSettings().GetTerritory().TerritorySize );
+
+		return m_TerritoryFlagGrid;
 	}
 	
 	// ------------------------------------------------------------
@@ -1895,15 +2011,18 @@ class ExpansionTerritoryModule: JMModuleBase
 		
 		if (IsMissionHost())
 		{
-			for (int idx; idx < m_TerritoryFlags.Count(); ++idx)
+			TIntArray territoryIDs = new TIntArray;
+			GetTerritoryFlagGrid().GetInRadius( position, territorySize, territoryIDs );
+
+			for (int idx = 0; idx < territoryIDs.Count(); ++idx)
 			{
-				ExpansionTerritoryFlag flag = m_TerritoryFlags.GetElement(idx);
+				ExpansionTerritoryFlag flag = m_TerritoryFlags.Get( territoryIDs[idx] );
 				if (!flag) continue;
 				
 				ExpansionTerritory currTerritory = flag.GetTerritory();
 				if (!currTerritory) continue;
 				
-				if ( vector.Distance( currTerritory.GetPosition(), position ) <= territorySize && currTerritory.IsMember(playerUID) )
+				if ( currTerritory.IsMember(playerUID) )
 				{
 					return true;
 				}
@@ -1935,6 +2054,14 @@ class ExpansionTerritoryModule: JMModuleBase
 		{
 			territorySize = GetExpansionSettings().GetTerritory().TerritorySize;
 		}
+
+		if ( IsMissionHost() )
+		{
+			TIntArray territoryIDs = new TIntArray;
+			GetTerritoryFlagGrid().GetInRadius( position, territorySize, territoryIDs );
+
+			return territoryIDs.Count() > 0;
+		}
 		
 		array<Object> objects = new array<Object>;
 		array<CargoBase> proxyCargos = new array<CargoBase> ;
@@ -29,6 +29,5 @@ enum ExpansionTerritoryModuleRPC
 	RequestServerTerritories,
 	SendServerTerritories,
 	Leave,
-	PlayerEnteredTerritory,
     COUNT
 }
\ No newline at end of file
@@ -16,6 +16,9 @@ modded class BuildingBase
 	static autoptr array<BuildingBase> m_AllBuldingsInteriors = new array<BuildingBase>;
 	
 	protected ExpansionInteriorBuildingModule m_InteriorModule;
+
+	//! Set while CollectInteriorClasses runs, SpawnInteriorObject then only records the class
+	protected static TStringArray s_CollectedInteriorClasses;
 	
 	private bool m_Loading;
 
@@ -93,7 +96,7 @@ modded class BuildingBase
 
 	protected Object SpawnInteriorIvy( string type, vector position, vector orientation )
 	{
-		if ( !m_IsIvyBuilding )
+		if ( !m_IsIvyBuilding || s_CollectedInteriorClasses )
 			return NULL;
 
 		ConvertTransformToWorld( position, orientation, position, orientation );
@@ -123,6 +126,14 @@ modded class BuildingBase
 	
 	protected Object SpawnInteriorObject( string type, vector position, vector orientation, float random = 1.0 )
 	{
+		if ( s_CollectedInteriorClasses )
+		{
+			if ( s_CollectedInteriorClasses.Find( type ) == -1 )
+				s_CollectedInteriorClasses.Insert( type );
+
+			return NULL;
+		}
+
 		if ( random == -1 )
 		{
 			random = Math.RandomFloatInclusive( 0, 1 );
@@ -134,23 +145,8 @@ modded class BuildingBase
 			
 			ConvertTransformToWorld( position, orientation, position, orientation );
 
-			Object obj;
-			if ( !m_InteriorModule.m_CachedCollision.Find( type, hasCollision ) )
-			{
-				obj = GetGame().CreateObject_WIP( type, position, ECE_CREATEPHYSICS | ECE_CREATELOCAL );
-				if ( !obj )
-				{
-					m_InteriorModule.m_CachedCollision.Insert( type, false );
-					return NULL;
-				}
-				
-				vector minMax[2];
-				hasCollision = obj.GetCollisionBox( minMax );
-				
-				m_InteriorModule.m_CachedCollision.Insert( type, hasCollision );
-				
-				GetGame().ObjectDelete( obj );
-			}
+			if ( !m_InteriorModule.GetCollisionClass( type, hasCollision ) )
+				return NULL;
 
 			//Only spawn object with collision at server side, and object without collision at client side 
 			if ( hasCollision )
@@ -172,7 +168,7 @@ modded class BuildingBase
 			if ( IsMissionClient() )
 				flags |= ECE_CREATELOCAL; // create_local
 			
-			obj = GetGame().CreateObject_WIP( type, position, flags );
+			Object obj = GetGame().CreateObject_WIP( type, position, flags );
 			if ( !obj )
 				return NULL;
 			
@@ -263,8 +259,6 @@ modded class BuildingBase
 				SpawnInterior();
 		
 				GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).CallLater( GetGame().UpdatePathgraphRegionByObject, 100, false, this );
-				
-				m_InteriorModule.SaveCachedCollisions();
 			} else
 			{
 				#ifdef EXPANSIONEXLOGPRINT
@@ -278,6 +272,16 @@ modded class BuildingBase
 		#endif
 	}
 	
+	//! Adds the classes spawned by the interior to classNames without spawning anything
+	void CollectInteriorClasses( TStringArray classNames )
+	{
+		s_CollectedInteriorClasses = classNames;
+
+		SpawnInterior();
+
+		s_CollectedInteriorClasses = NULL;
+	}
+	
 	bool HasInterior()
 	{
 		return false;
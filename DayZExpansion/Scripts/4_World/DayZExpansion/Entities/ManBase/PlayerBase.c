@@ -56,7 +56,6 @@ modded class PlayerBase
 	protected ref ExpansionHumanVehicleCommand_ST m_ExpansionVehicleCommandST;
 	protected ref ExpansionHumanFallCommand_ST m_ExpansionFallCommandST;
 
-	protected ref ExpansionKillFeedData m_KillFeedData;
 	//! protected ref array<ref ExpansionQuest> m_Quests;
 	
 	protected string m_PlayerUID;
@@ -91,10 +90,8 @@ modded class PlayerBase
 		m_TerritoryIdInside = -1;
 
 		Class.CastTo( m_TerritoryModule, GetModuleManager().GetModule( ExpansionTerritoryModule ) );
-		Class.CastTo( m_KillfeedModule, GetModuleManager().GetModule( ExpansionHumanityModule ) );
-		Class.CastTo( m_HumanityModule, GetModuleManager().GetModule( ExpansionKillFeedModule ) );
-
-		//! m_KillFeedData = null;
+		Class.CastTo( m_KillfeedModule, GetModuleManager().GetModule( ExpansionKillFeedModule ) );
+		Class.CastTo( m_HumanityModule, GetModuleManager().GetModule( ExpansionHumanityModule ) );
 
 		m_MarketReserve = new ExpansionMarketReserve; 
 		m_MarketSell = new ExpansionMarketSell;
@@ -174,9 +171,6 @@ modded class PlayerBase
 			delete m_HumanityUpdateTimer;
 		}
 
-		if ( m_KillFeedData )
-			delete m_KillFeedData;
-
 		delete m_MarketReserve; 
 		delete m_MarketSell;
 
@@ -1222,18 +1216,9 @@ modded class PlayerBase
 		return super.HeadingModel( pDt, pModel );
 	}
 
-	// ------------------------------------------------------------
-	// PlayerBase ClearKillFeedData
-	// ------------------------------------------------------------
-	void ClearKillFeedData()
-	{
-		m_KillFeedData = null;
-	}
-
 	// ------------------------------------------------------------
 	// Expansion EEHitBy
 	// ------------------------------------------------------------
-	/*
 	override void EEHitBy(TotalDamageResult damageResult, int damageType, EntityAI source, int component, string dmgZone, string ammo, vector modelPos, float speedCoef)
 	{
 		#ifdef EXPANSIONEXPRINT
@@ -1243,41 +1228,37 @@ modded class PlayerBase
 		super.EEHitBy( damageResult, damageType, source, component, dmgZone, ammo, modelPos, speedCoef );		
 
 		//! Kill-Feed
-		if ( GetExpansionSettings().GetGeneral().EnableKillFeed )
+		if ( GetGame().IsServer() && GetExpansionSettings().GetGeneral().EnableKillFeed )
 		{
-			if ( m_KillFeedData )
-				delete m_KillFeedData;
-			
-			m_KillFeedData = new ExpansionKillFeedData( damageType, source, ammo );
-			
-			GetGame().GetCallQueue( CALL_CATEGORY_SYSTEM ).CallLater( this.ClearKillFeedData, 3000, false );
+			if ( m_KillfeedModule )
+				m_KillfeedModule.OnPlayerHitEvent( this, damageType, source, ammo );
 		}
 		
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("PlayerBase::EEHitBy - End");
 		#endif
 	}
-	*/
 
 	// ------------------------------------------------------------
 	// Expansion EEKilled
 	// ------------------------------------------------------------
-	/*
 	override void EEKilled( Object killer )
 	{
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("PlayerBase::EEKilled - Start");
 		#endif
 
-		if ( GetExpansionSettings().GetGeneral().EnableKillFeed && m_KillfeedModule )
+		if ( GetGame().IsServer() && GetExpansionSettings().GetGeneral().EnableKillFeed && m_KillfeedModule )
 		{
 			m_KillfeedModule.OnPlayerKilledEventNew( this, killer );
 		}
 
+		/*
 		if ( GetExpansionSettings().GetGeneral().EnableHumanity && m_HumanityModule )
 		{
 			m_HumanityModule.OnPlayerKilledEvent( this, killer );
 		}
+		*/
 
 		super.EEKilled( killer );
 
@@ -1285,15 +1266,6 @@ modded class PlayerBase
 		EXPrint("PlayerBase::EEKilled - End");
 		#endif
 	}
-	*/
-	
-	// ------------------------------------------------------------
-	// PlayerBase GetCurrentHitData
-	// ------------------------------------------------------------
-	ExpansionKillFeedData GetCurrentHitData()
-	{
-		return m_KillFeedData;
-	}
 	
 	// ------------------------------------------------------------
 	// PlayerBase AddQuest
@@ -40,6 +40,10 @@ modded class JMModuleConstructor
 		// modules.Insert( ExpansionGameMissionSelecterModule );
 		// modules.Insert( ExpansionAnimalAITestModule );			
 		// modules.Insert( ExpansionAITestModule );					
+		// modules.Insert( ExpansionPartyBenchmarkModule );
+		// modules.Insert( ExpansionMappingCompilerModule );
+		// modules.Insert( ExpansionMarketReportModule );
+		// modules.Insert( ExpansionMarketPriceTestModule );
 		// modules.Insert( ExpansionMarketCOTModule );					
 		// modules.Insert( ExpansionMissionCOTModule );	
 
@@ -0,0 +1,131 @@
+/**
+ * ExpansionMappingCompilerModule.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2020 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionMappingCompilerModule
+ * @brief		Converts the .map files of the current world listed in the general settings
+ *				to the compiled .mapb format when the mission starts. The output goes to
+ *				$profile:ExpansionMod\Mapping\<world>\ and has to be copied next to the .map
+ *				files in DayZExpansion/Scripts/Data/Mapping/<world>/ before packing.
+ *				It also prebuilds the collision cache from the classes used by the mappings and
+ *				by the interiors of the buildings of the world, $profile:ExpansionMod\CollisionCache.bin
+ *				has to be copied to DayZExpansion/Scripts/Data/CollisionCache.bin to ship it.
+ *				Not registered by default.
+ **/
+class ExpansionMappingCompilerModule: JMModuleBase
+{
+	// ------------------------------------------------------------
+	// Override OnMissionStart
+	// ------------------------------------------------------------
+	override void OnMissionStart()
+	{
+		super.OnMissionStart();
+
+		if ( !IsMissionHost() || !GetExpansionSettings().GetGeneral() )
+			return;
+
+		string worldName = g_Game.GetWorldName();
+		worldName.ToLower();
+		if ( worldName.Contains( "chernarusplus" ) )
+			worldName = "chernarusplus";
+
+		TStringArray names = new TStringArray;
+		names.InsertAll( GetExpansionSettings().GetGeneral().Mapping.Mapping );
+		names.InsertAll( GetExpansionSettings().GetGeneral().Mapping.ObjectsToDelete );
+
+		Compile( worldName, names );
+
+		PrebuildCollisionCache( worldName, GetExpansionSettings().GetGeneral().Mapping.Mapping );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionMappingCompilerModule Compile
+	// ------------------------------------------------------------
+	void Compile( string worldName, TStringArray names )
+	{
+		string inputFolder = EXPANSION_MAPPING_FOLDER + worldName + "/";
+		string outputFolder = EXPANSION_MAPPING_COMPILED_FOLDER + worldName + "\\";
+
+		if ( !FileExist( EXPANSION_MAPPING_COMPILED_FOLDER ) )
+			MakeDirectory( EXPANSION_MAPPING_COMPILED_FOLDER );
+
+		if ( !FileExist( outputFolder ) )
+			MakeDirectory( outputFolder );
+
+		int compiled = 0;
+
+		for ( int i = 0; i < names.Count(); i++ )
+		{
+			ExpansionCompiledMapping mapping = ExpansionCompiledMapping.LoadText( inputFolder + names[i] + EXPANSION_MAPPING_EXT );
+			if ( !mapping )
+			{
+				Print( "[ExpansionMappingCompilerModule] Could not read " + inputFolder + names[i] + EXPANSION_MAPPING_EXT );
+				continue;
+			}
+
+			if ( !mapping.Save( outputFolder + names[i] + EXPANSION_MAPPING_COMPILED_EXT ) )
+			{
+				Print( "[ExpansionMappingCompilerModule] Could not write " + outputFolder + names[i] + EXPANSION_MAPPING_COMPILED_EXT );
+				continue;
+			}
+
+			Print( "[ExpansionMappingCompilerModule] Compiled " + names[i] + ": " + mapping.Count() + " objects, " + mapping.ClassNames.Count() + " class names" );
+			compiled++;
+		}
+
+		Print( "[ExpansionMappingCompilerModule] Compiled " + compiled + " of " + names.Count() + " mapping files to " + outputFolder );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionMappingCompilerModule PrebuildCollisionCache
+	// ------------------------------------------------------------
+	void PrebuildCollisionCache( string worldName, TStringArray names )
+	{
+		ExpansionInteriorBuildingModule interiorModule;
+		if ( !Class.CastTo( interiorModule, GetModuleManager().GetModule( ExpansionInteriorBuildingModule ) ) )
+			return;
+
+		string inputFolder = EXPANSION_MAPPING_FOLDER + worldName + "/";
+
+		TStringArray classNames = new TStringArray;
+
+		int i;
+		int j;
+		for ( i = 0; i < names.Count(); i++ )
+		{
+			ExpansionCompiledMapping mapping = ExpansionCompiledMapping.Load( inputFolder, names[i] );
+			if ( !mapping )
+				continue;
+
+			for ( j = 0; j < mapping.ClassNames.Count(); j++ )
+			{
+				if ( classNames.Find( mapping.ClassNames[j] ) == -1 )
+					classNames.Insert( mapping.ClassNames[j] );
+			}
+		}
+
+		//! One building of each type is enough, they all spawn the same interior
+		TStringArray buildingTypes = new TStringArray;
+		for ( i = 0; i < BuildingBase.m_AllBuldingsInteriors.Count(); i++ )
+		{
+			BuildingBase building = BuildingBase.m_AllBuldingsInteriors[i];
+			if ( !building || buildingTypes.Find( building.GetType() ) != -1 )
+				continue;
+
+			buildingTypes.Insert( building.GetType() );
+			building.CollectInteriorClasses( classNames );
+		}
+
+		Print( "[ExpansionMappingCompilerModule] Collected " + classNames.Count() + " classes from " + names.Count() + " mapping files and " + buildingTypes.Count() + " building interiors" );
+
+		interiorModule.PrebuildCollisionCache( classNames, EXPANSION_COLLISION_CACHE );
+	}
+}
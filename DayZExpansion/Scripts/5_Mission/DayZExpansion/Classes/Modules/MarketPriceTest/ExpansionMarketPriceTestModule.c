@@ -0,0 +1,123 @@
+/**
+ * ExpansionMarketPriceTestModule.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2020 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionMarketPriceTestModule
+ * @brief		Checks ExpansionMarketItem.CalculatePriceRange against a per-unit loop over
+ *				every range of a set of price and stock thresholds. The clamped stock levels
+ *				are priced one by one, the ones between the thresholds are summed unit by unit
+ *				and rounded once. Also checks that CalculatePrice is the range of one stock level.
+ *				Prints the mismatches to the script log when the mission starts. Not registered by default.
+ **/
+class ExpansionMarketPriceTestModule: JMModuleBase
+{
+	// ------------------------------------------------------------
+	// Override OnMissionStart
+	// ------------------------------------------------------------
+	override void OnMissionStart()
+	{
+		super.OnMissionStart();
+
+		array< ref ExpansionMarketItem > items = new array< ref ExpansionMarketItem >;
+
+		//! Linear curve, with prices that don't divide evenly between the thresholds
+		items.Insert( new ExpansionMarketItem( 0, "test_linear", 3, 47, 1, 100, 0 ) );
+		items.Insert( new ExpansionMarketItem( 0, "test_linear_wide", 1, 7, 5, 300, 0 ) );
+		items.Insert( new ExpansionMarketItem( 0, "test_linear_narrow", 100, 1000, 10, 12, 0 ) );
+		items.Insert( new ExpansionMarketItem( 0, "test_linear_gap", 10, 11, 0, 1, 0 ) );
+
+		//! Static price and static stock
+		items.Insert( new ExpansionMarketItem( 0, "test_static_price", 25, 25, 1, 100, 0 ) );
+		items.Insert( new ExpansionMarketItem( 0, "test_static_stock", 5, 50, 20, 20, 0 ) );
+
+		//! Minimum stock above the maximum stock
+		items.Insert( new ExpansionMarketItem( 0, "test_inverted", 5, 50, 60, 40, 0 ) );
+
+		int ranges;
+		int failures;
+
+		for ( int i = 0; i < items.Count(); i++ )
+		{
+			ExpansionMarketItem item = items[i];
+
+			int maxStock = Math.Max( item.MinStockThreshold, item.MaxStockThreshold ) + 3;
+
+			for ( int stock = -2; stock <= maxStock; stock++ )
+			{
+				ranges++;
+
+				if ( item.CalculatePrice( stock ) != item.CalculatePriceRange( stock, stock ) )
+				{
+					failures++;
+
+					Print( "[ExpansionMarketPriceTestModule] " + item.ClassName + " stock " + stock + " : price " + item.CalculatePrice( stock ) + ", range " + item.CalculatePriceRange( stock, stock ) );
+				}
+			}
+
+			for ( int stockFrom = -2; stockFrom <= maxStock; stockFrom++ )
+			{
+				for ( int stockTo = stockFrom - 1; stockTo <= maxStock; stockTo++ )
+				{
+					ExpansionMarketCurrency expected = SumPrices( item, stockFrom, stockTo );
+					ExpansionMarketCurrency actual = item.CalculatePriceRange( stockFrom, stockTo );
+
+					ranges++;
+
+					if ( actual != expected )
+					{
+						failures++;
+
+						Print( "[ExpansionMarketPriceTestModule] " + item.ClassName + " stock " + stockFrom + " to " + stockTo + " : expected " + expected + ", got " + actual );
+					}
+				}
+			}
+		}
+
+		Print( "[ExpansionMarketPriceTestModule] " + ranges + " ranges checked, " + failures + " failures" );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionMarketPriceTestModule SumPrices
+	// The per-unit loop CalculatePriceRange replaces
+	// ------------------------------------------------------------
+	private ExpansionMarketCurrency SumPrices( ExpansionMarketItem item, int stockFrom, int stockTo )
+	{
+		ExpansionMarketCurrency total = 0;
+
+		int linearCount = 0;
+		int linearSteps = 0;
+
+		for ( int stock = stockFrom; stock <= stockTo; stock++ )
+		{
+			if ( item.StaticPrice == 0 && !item.StaticStock && stock > item.MinStockThreshold && stock < item.MaxStockThreshold )
+			{
+				//! Distance to the maximum stock, the price is MinPriceThreshold plus a share of the price range per step
+				linearCount++;
+				linearSteps += item.MaxStockThreshold - stock;
+			}
+			else
+			{
+				total += item.CalculatePrice( stock );
+			}
+		}
+
+		if ( linearCount > 0 )
+		{
+			float steps = linearSteps;
+			float priceRange = item.MaxPriceThreshold - item.MinPriceThreshold;
+			float stockRange = item.MaxStockThreshold - item.MinStockThreshold;
+
+			total += linearCount * item.MinPriceThreshold + Math.Round( steps * priceRange / stockRange );
+		}
+
+		return total;
+	}
+}
@@ -0,0 +1,222 @@
+/**
+ * ExpansionMarketReportModule.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2020 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+class ExpansionMarketReportPricePoint
+{
+	//! "YYYY-MM-DD hh"
+	string Hour;
+	int Quantity;
+	int Value;
+	float AverageUnitPrice;
+}
+
+class ExpansionMarketReportItem
+{
+	string ClassName;
+
+	//! Unit prices stay 0 while the item has no purchases or no sales
+	int Purchases;
+	int QuantityBought;
+	int ValueBought;
+	float MinBuyUnitPrice;
+	float MaxBuyUnitPrice;
+
+	int Sales;
+	int QuantitySold;
+	int ValueSold;
+	float MinSellUnitPrice;
+	float MaxSellUnitPrice;
+
+	//! Hourly prices of purchases and sales, kept apart as they don't follow the same price
+	ref array< ref ExpansionMarketReportPricePoint > PurchaseCurve;
+	ref array< ref ExpansionMarketReportPricePoint > SaleCurve;
+
+	void ExpansionMarketReportItem()
+	{
+		PurchaseCurve = new array< ref ExpansionMarketReportPricePoint >;
+		SaleCurve = new array< ref ExpansionMarketReportPricePoint >;
+	}
+}
+
+class ExpansionMarketReport
+{
+	int Records;
+	ref array< ref ExpansionMarketReportItem > Items;
+
+	void ExpansionMarketReport()
+	{
+		Items = new array< ref ExpansionMarketReportItem >;
+	}
+}
+
+/**@class		ExpansionMarketReportModule
+ * @brief		Reads the market records of the event streams in $profile:ExpansionMod\Logs\Events\
+ *				when the mission starts and writes the trade volume and the hourly purchase and sale price curves
+ *				of every item to $profile:ExpansionMod\Logs\MarketReport.json.
+ *				Not registered by default.
+ **/
+class ExpansionMarketReportModule: JMModuleBase
+{
+	static const string REPORT_FILE = EXPANSION_LOG_FOLDER + "MarketReport.json";
+
+	protected ref ExpansionMarketReport m_Report;
+	protected ref map< string, ref ExpansionMarketReportItem > m_Items;
+	protected ref map< string, ref ExpansionMarketReportPricePoint > m_PricePoints;
+
+	// ------------------------------------------------------------
+	// Override OnMissionStart
+	// ------------------------------------------------------------
+	override void OnMissionStart()
+	{
+		super.OnMissionStart();
+
+		if ( !IsMissionHost() )
+			return;
+
+		Run();
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionMarketReportModule Run
+	// ------------------------------------------------------------
+	void Run()
+	{
+		if ( !FileExist( EXPANSION_EVENTS_LOG_FOLDER ) )
+			return;
+
+		m_Report = new ExpansionMarketReport;
+		m_Items = new map< string, ref ExpansionMarketReportItem >;
+		m_PricePoints = new map< string, ref ExpansionMarketReportPricePoint >;
+
+		TStringArray files = FindFilesInLocation( EXPANSION_EVENTS_LOG_FOLDER );
+
+		int start = TickCount( 0 );
+
+		for ( int i = 0; i < files.Count(); i++ )
+		{
+			if ( files[i].Contains( EXPANSION_EVENTS_LOG_EXT ) )
+				ReadFile( EXPANSION_EVENTS_LOG_FOLDER + files[i] );
+		}
+
+		for ( int j = 0; j < m_PricePoints.Count(); j++ )
+		{
+			ExpansionMarketReportPricePoint point = m_PricePoints.GetElement( j );
+			if ( point.Quantity > 0 )
+				point.AverageUnitPrice = point.Value / ( point.Quantity * 1.0 );
+		}
+
+		JsonFileLoader< ExpansionMarketReport >.JsonSaveFile( REPORT_FILE, m_Report );
+
+		Print( "[ExpansionMarketReportModule] " + m_Report.Records + " market records, " + m_Report.Items.Count() + " items from " + files.Count() + " files in " + ( TickCount( start ) / 10000.0 ) + "ms, written to " + REPORT_FILE );
+
+		m_Items = NULL;
+		m_PricePoints = NULL;
+		m_Report = NULL;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionMarketReportModule ReadFile
+	// Only the lines of market records are deserialized
+	// ------------------------------------------------------------
+	protected void ReadFile( string path )
+	{
+		int file = OpenFile( path, FileMode.READ );
+		if ( file == 0 )
+			return;
+
+		JsonSerializer serializer = new JsonSerializer;
+
+		string purchase = "\"" + ExpansionMarketEventRecord.PURCHASE + "\"";
+		string sell = "\"" + ExpansionMarketEventRecord.SELL + "\"";
+
+		string line;
+		string error;
+		while ( FGets( file, line ) > 0 )
+		{
+			if ( !line.Contains( purchase ) && !line.Contains( sell ) )
+				continue;
+
+			ExpansionMarketEventRecord record = new ExpansionMarketEventRecord;
+			if ( serializer.ReadFromString( record, line, error ) )
+				AddRecord( record );
+		}
+
+		CloseFile( file );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionMarketReportModule AddRecord
+	// ------------------------------------------------------------
+	protected void AddRecord( ExpansionMarketEventRecord record )
+	{
+		//! "YYYY-MM-DD hh" is needed for the hourly curve
+		if ( record.quantity <= 0 || record.time.Length() < 13 )
+			return;
+
+		ExpansionMarketReportItem item;
+		if ( !m_Items.Find( record.item, item ) )
+		{
+			item = new ExpansionMarketReportItem;
+			item.ClassName = record.item;
+
+			m_Items.Insert( record.item, item );
+			m_Report.Items.Insert( item );
+		}
+
+		float unitPrice = record.price / ( record.quantity * 1.0 );
+
+		if ( record.type == ExpansionMarketEventRecord.PURCHASE )
+		{
+			if ( item.Purchases == 0 || unitPrice < item.MinBuyUnitPrice )
+				item.MinBuyUnitPrice = unitPrice;
+			if ( item.Purchases == 0 || unitPrice > item.MaxBuyUnitPrice )
+				item.MaxBuyUnitPrice = unitPrice;
+
+			item.Purchases++;
+			item.QuantityBought += record.quantity;
+			item.ValueBought += record.price;
+		}
+		else
+		{
+			if ( item.Sales == 0 || unitPrice < item.MinSellUnitPrice )
+				item.MinSellUnitPrice = unitPrice;
+			if ( item.Sales == 0 || unitPrice > item.MaxSellUnitPrice )
+				item.MaxSellUnitPrice = unitPrice;
+
+			item.Sales++;
+			item.QuantitySold += record.quantity;
+			item.ValueSold += record.price;
+		}
+
+		string hour = record.time.Substring( 0, 13 );
+		string key = record.type + " " + record.item + " " + hour;
+
+		ExpansionMarketReportPricePoint point;
+		if ( !m_PricePoints.Find( key, point ) )
+		{
+			point = new ExpansionMarketReportPricePoint;
+			point.Hour = hour;
+
+			m_PricePoints.Insert( key, point );
+
+			if ( record.type == ExpansionMarketEventRecord.PURCHASE )
+				item.PurchaseCurve.Insert( point );
+			else
+				item.SaleCurve.Insert( point );
+		}
+
+		point.Quantity += record.quantity;
+		point.Value += record.price;
+
+		m_Report.Records++;
+	}
+}
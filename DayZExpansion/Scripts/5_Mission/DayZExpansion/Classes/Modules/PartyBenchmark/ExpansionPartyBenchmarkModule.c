@@ -0,0 +1,137 @@
+/**
+ * ExpansionPartyBenchmarkModule.c
+ *
+ * DayZ Expansion Mod
+ * www.dayzexpansion.com
+ * © 2020 DayZ Expansion Mod Team
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivatives 4.0 International License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/4.0/.
+ *
+*/
+
+/**@class		ExpansionPartyBenchmarkModule
+ * @brief		Compares party loading from one JSON file per party with the party database.
+ *				Generates synthetic parties in a scratch folder when the mission starts and
+ *				prints the timings to the script log. Not registered by default.
+ **/
+class ExpansionPartyBenchmarkModule: JMModuleBase
+{
+	static const string BENCHMARK_FOLDER = EXPANSION_FOLDER + "PartyBenchmark\\";
+
+	static const int PARTY_COUNT = 1000;
+	static const int MEMBERS_PER_PARTY = 8;
+	static const int MARKERS_PER_PARTY = 20;
+
+	// ------------------------------------------------------------
+	// Override OnMissionStart
+	// ------------------------------------------------------------
+	override void OnMissionStart()
+	{
+		super.OnMissionStart();
+
+		if ( !IsMissionHost() )
+			return;
+
+		Run( PARTY_COUNT );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionPartyBenchmarkModule Run
+	// ------------------------------------------------------------
+	void Run( int partyCount )
+	{
+		if ( !FileExist( BENCHMARK_FOLDER ) )
+			MakeDirectory( BENCHMARK_FOLDER );
+
+		map< int, ref ExpansionPartySaveFormat > parties = CreateParties( partyCount );
+
+		int i;
+		int start;
+		string path;
+
+		//! One JSON file per party, how parties are stored by default
+		start = TickCount( 0 );
+		for ( i = 0; i < parties.Count(); i++ )
+		{
+			JsonFileLoader< ExpansionPartySaveFormat >.JsonSaveFile( BENCHMARK_FOLDER + parties.GetKey( i ) + ".json", parties.GetElement( i ) );
+		}
+		float jsonSave = ToMilliseconds( TickCount( start ) );
+
+		start = TickCount( 0 );
+		for ( i = 0; i < parties.Count(); i++ )
+		{
+			ExpansionPartySaveFormat party;
+			JsonFileLoader< ExpansionPartySaveFormat >.JsonLoadFile( BENCHMARK_FOLDER + parties.GetKey( i ) + ".json", party );
+			party.InitMaps();
+		}
+		float jsonLoad = ToMilliseconds( TickCount( start ) );
+
+		//! Party database, markers are loaded later on demand so they are not part of the load
+		path = BENCHMARK_FOLDER + "Groups.bin";
+
+		start = TickCount( 0 );
+		ExpansionPartyDatabase.Save( path, parties );
+		float databaseSave = ToMilliseconds( TickCount( start ) );
+
+		map< int, ref ExpansionPartySaveFormat > loaded = new map< int, ref ExpansionPartySaveFormat >;
+
+		start = TickCount( 0 );
+		bool success = ExpansionPartyDatabase.Load( path, loaded );
+		for ( i = 0; i < loaded.Count(); i++ )
+		{
+			loaded.GetElement( i ).InitMaps();
+		}
+		float databaseLoad = ToMilliseconds( TickCount( start ) );
+
+		Print( "[ExpansionPartyBenchmarkModule] " + partyCount + " parties, " + MEMBERS_PER_PARTY + " members and " + MARKERS_PER_PARTY + " markers each" );
+		Print( "[ExpansionPartyBenchmarkModule] JSON files : save " + jsonSave + " ms, load " + jsonLoad + " ms" );
+		Print( "[ExpansionPartyBenchmarkModule] Database : save " + databaseSave + " ms, load " + databaseLoad + " ms, loaded " + loaded.Count() + " parties, success " + success );
+
+		for ( i = 0; i < parties.Count(); i++ )
+		{
+			DeleteFile( BENCHMARK_FOLDER + parties.GetKey( i ) + ".json" );
+		}
+
+		DeleteFile( path );
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionPartyBenchmarkModule CreateParties
+	// ------------------------------------------------------------
+	private map< int, ref ExpansionPartySaveFormat > CreateParties( int partyCount )
+	{
+		map< int, ref ExpansionPartySaveFormat > parties = new map< int, ref ExpansionPartySaveFormat >;
+
+		for ( int i = 0; i < partyCount; i++ )
+		{
+			ExpansionPartySaveFormat party = new ExpansionPartySaveFormat( i );
+			party.SetupExpansionPartySaveFormat( "7656119800000" + i, "Owner " + i, "Party " + i );
+
+			for ( int j = 1; j < MEMBERS_PER_PARTY; j++ )
+			{
+				party.AddMember( "7656119800000" + i + "_" + j, "Member " + i + "_" + j );
+			}
+
+			party.AddInvite( "7656119900000" + i );
+
+			for ( int k = 0; k < MARKERS_PER_PARTY; k++ )
+			{
+				party.AddMarker( new ExpansionMapMarker( "Marker " + k, k % 10, Vector( Math.RandomFloat( 0, 15000 ), 0, Math.RandomFloat( 0, 15000 ) ), ARGB( 255, 255, 180, 24 ), true, k % 2 == 0 ) );
+			}
+
+			parties.Insert( i, party );
+		}
+
+		return parties;
+	}
+
+	// ------------------------------------------------------------
+	// ExpansionPartyBenchmarkModule ToMilliseconds
+	// TickCount is in 100 ns units
+	// ------------------------------------------------------------
+	private float ToMilliseconds( int ticks )
+	{
+		return ticks / 10000.0;
+	}
+}
@@ -94,8 +94,6 @@ class ExpansionMarketMenu extends UIScriptedMenu
 	protected vector 									m_ItemOrientation;
 	protected int										m_ItemScaleDelta;
 
-	protected float 									m_RequestMarketTraderDataAccum;
-
 	protected bool										m_WasGPSVisible;
 
 	protected Widget									m_PopupDialog;
@@ -610,9 +608,13 @@ class ExpansionMarketMenu extends UIScriptedMenu
 		int toSpawn = 0;
 		bool canPurchase = false;
 		
+		//! Enumerate the player inventory once for all the price lookups below
+		PlayerBase player = PlayerBase.Cast( GetGame().GetPlayer() );
+		ExpansionMarketPlayerInventory inventory = new ExpansionMarketPlayerInventory( player, m_MarketModule );
+
 		ExpansionMarketSell marketSell = new ExpansionMarketSell;
 		// marketSell.Trader = trader;
-		if ( m_MarketModule.FindSellPrice( PlayerBase.Cast( GetGame().GetPlayer() ), item, m_TraderStock, m_Quantity, marketSell ) )
+		if ( m_MarketModule.FindSellPrice( player, item, m_TraderStock, m_Quantity, marketSell, inventory ) )
 		{
 			m_SellPrice = marketSell.Price;
 
@@ -684,7 +686,7 @@ class ExpansionMarketMenu extends UIScriptedMenu
 		array< int > monies = new array< int >;
 
 		string name;
-		m_MarketModule.FindMoneyAndCountTypes( PlayerBase.Cast(GetGame().GetPlayer()), m_SellPrice, monies );
+		m_MarketModule.FindMoneyAndCountTypes( player, m_SellPrice, monies, inventory );
 		for ( i = 0; i < monies.Count(); i++ )
 		{
 			if ( i >= m_MarketSellPriceTypes.Count() )
@@ -697,7 +699,7 @@ class ExpansionMarketMenu extends UIScriptedMenu
 		}
 
 		monies.Clear();
-		m_MarketModule.FindMoneyAndCountTypes( PlayerBase.Cast(GetGame().GetPlayer()), m_BuyPrice, monies );
+		m_MarketModule.FindMoneyAndCountTypes( player, m_BuyPrice, monies, inventory );
 		for ( i = 0; i < monies.Count(); i++ )
 		{
 			if ( i >= m_MarketBuyPriceTypes.Count() )
@@ -1116,6 +1118,10 @@ class ExpansionMarketMenu extends UIScriptedMenu
 		
 		super.OnHide();
 
+		//! Stop receiving stock updates of this trader
+		if ( m_Trader )
+			m_MarketModule.ExitTrader( m_Trader );
+
 		PPEffects.SetBlurMenu( 0 );
 
 		MissionGameplay.Cast( GetGame().GetMission() ).PlayerControlEnable(true);
@@ -1144,14 +1150,6 @@ class ExpansionMarketMenu extends UIScriptedMenu
 			return;
 		}
 
-		m_RequestMarketTraderDataAccum += timeslice;
-		if ( m_RequestMarketTraderDataAccum > 0.5 )
-		{
-			m_RequestMarketTraderDataAccum = 0;
-
-			m_MarketModule.RequestTraderData( m_Trader );
-		}
-
 		UpdateUIValues();
 
 		//When typing in search box
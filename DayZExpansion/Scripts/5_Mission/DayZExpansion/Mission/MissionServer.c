@@ -99,6 +99,10 @@ modded class MissionServer
 
 		//! Save settings on mission finish
 		g_exGlobalSettings.Save();
+
+		//! Write the lines still buffered by the logger
+		if ( g_exLogger )
+			g_exLogger.Flush();
 		
 		#ifdef EXPANSIONEXPRINT
 		EXPrint("MissionServer::OnMissionFinish - End");